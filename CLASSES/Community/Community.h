@@ -7,21 +7,56 @@
 #include <algorithm>  // for set operations
 #include <memory>     // for unique_ptr
 #include <utility>
+#include <unordered_set>  // for member lookups in calculateWeights
+#include <unordered_map>  // for node -> community labels
+#include <functional>     // for std::hash
+#include <cstdint>        // for uint64_t
+#include "CommunityStorage.h"
 
 
 using namespace std;
 
+// Order-independent fingerprint of a set of nodes: the sum of the mixed node
+// hashes plus the size. Equal node sets always get equal fingerprints, no
+// matter how the members are stored or in which order they are visited.
+template <typename Iterator>
+uint64_t fingerprintNodes(Iterator first, Iterator last) {
+    using Node = typename iterator_traits<Iterator>::value_type;
+    uint64_t sum = 0;
+    uint64_t count = 0;
+    for(; first != last; ++first) {
+        // splitmix64 finalizer, std::hash of an integer is the integer itself
+        uint64_t x = static_cast<uint64_t>(hash<Node>()(*first)) + 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        sum += x ^ (x >> 31);
+        ++count;
+    }
+    return sum + count * 0x2545f4914f6cdd1dULL;
+}
+
 // Forward declaration - assuming Graph will be defined elsewhere
 template <typename T>
 class Graph;
 
 template <typename T>
+class IncrementalCommunityMaintainer;
+
+// Storage selects how the member nodes are kept (see CommunityStorage.h):
+// SetStorage by default, SortedVectorStorage or BitmapStorage for compact
+// integer-id communities.
+template <typename T, typename Storage = SetStorage<T>>
 class Community {
 private:
-    set<T> nodes;  // Changed from unordered_set to set
+    Storage nodes;  // ordered members, std::set unless another policy is chosen
     double internalWeight = 0.0;
     double externalWeight = 0.0;
     shared_ptr<Graph<T>> cachedGraphRef = nullptr; // last graph we calculated a score for
+    uint64_t cachedModificationCount = 0; // its getModificationCount() at that time
+    bool weightsValid = false; // cleared whenever the members change
+
+    // keeps the weights of its communities current while the graph changes
+    friend class IncrementalCommunityMaintainer<T>;
 
 public:
     Community() = default;
@@ -29,88 +64,189 @@ public:
     // Node operations
     void addNode(const T& node) {
         nodes.insert(node);
+        weightsValid = false;
+    }
+    
+    // Adds a range of nodes; sorted ranges are inserted in linear time
+    template <typename Iterator>
+    void addNodes(Iterator first, Iterator last) {
+        nodes.insertRange(first, last);
+        weightsValid = false;
     }
     
     void removeNode(const T& node) {
         nodes.erase(node);
+        weightsValid = false;
     }
     
     bool containsNode(const T& node) const {
-        return nodes.find(node) != nodes.end();
+        return nodes.contains(node);
     }
     
     size_t size() const {
         return nodes.size();
     }
     
-    const set<T>& getNodes() const {  // Changed return type
-        return nodes;
+    // const set<T>& for the default storage, an ordered iterable view otherwise
+    typename Storage::NodeView getNodes() const {
+        return nodes.nodes();
     }
     
     vector<T> getNodesSorted() const {
-        return vector<T>(nodes.begin(), nodes.end());
+        auto view = nodes.nodes();
+        return vector<T>(view.begin(), view.end());
     }
     
-    void merge(Community<T>& other) {
-        for(const auto& node: other.getNodes()) {
-            nodes.insert(node);
+    // True if the weights were calculated for the current members and the
+    // cached graph has not changed since
+    bool weightsCurrent() const {
+        return weightsValid && cachedGraphRef &&
+               cachedGraphRef->getModificationCount() == cachedModificationCount;
+    }
+
+    void merge(Community<T, Storage>& other) {
+        // With both weights current for the same graph, the merged weights
+        // follow from the cut between the two communities, which only needs
+        // the adjacency of the smaller one
+        bool incremental = weightsCurrent() && other.weightsCurrent() &&
+                           other.cachedGraphRef == cachedGraphRef && &other != this;
+        double cut = 0.0;
+        if(incremental) {
+            const Community<T, Storage>& smaller = size() <= other.size() ? *this : other;
+            const Community<T, Storage>& larger = size() <= other.size() ? other : *this;
+            for(const auto& node: smaller.getNodes()) {
+                if(larger.containsNode(node)) {
+                    // overlapping communities share edges, recompute below
+                    incremental = false;
+                    break;
+                }
+                if(!cachedGraphRef->hasVertex(node)) continue;
+                for(const auto& [neighbor, weight]: cachedGraphRef->getNeighbors(node)) {
+                    if(larger.containsNode(neighbor)) {
+                        cut += weight;
+                    }
+                }
+            }
         }
         
-        if(cachedGraphRef) {
+        nodes.insertAll(other.nodes);
+        
+        if(incremental) {
+            // cut edges turn internal; both weights are stored halved
+            internalWeight += other.internalWeight + cut / 2;
+            externalWeight += other.externalWeight - cut;
+        } else if(cachedGraphRef) {
             // Recalculate score with new nodes and old cached graph
             calculateWeights(cachedGraphRef);
         }
     }
     
-    Community<T> createUnion(const Community<T>& other) const {
-        Community<T> result;
-        std::set_union(
-            nodes.begin(), nodes.end(),
-            other.getNodes().begin(), other.getNodes().end(),
-            std::inserter(result.nodes, result.nodes.begin())
-        );
+    Community<T, Storage> createUnion(const Community<T, Storage>& other) const {
+        Community<T, Storage> result;
+        Storage::unite(nodes, other.nodes, result.nodes);
         return result;
     }
 
-    Community<T> createIntersection(const Community<T>& other) const {
-        Community<T> result;
-        std::set_intersection(
-            nodes.begin(), nodes.end(),
-            other.getNodes().begin(), other.getNodes().end(),
-            std::inserter(result.nodes, result.nodes.begin())
-        );
+    Community<T, Storage> createIntersection(const Community<T, Storage>& other) const {
+        Community<T, Storage> result;
+        Storage::intersect(nodes, other.nodes, result.nodes);
         return result;
     }
 
-    bool operator==(const Community<T>& other) const {
-        return nodes==other.getNodes();
+    bool operator==(const Community<T, Storage>& other) const {
+        return nodes==other.nodes;
+    }
+
+    // Orders by size, then by the sorted members, so communities can key a map
+    bool operator<(const Community<T, Storage>& other) const {
+        if(size() != other.size()) {
+            return size() < other.size();
+        }
+        auto mine = nodes.nodes();
+        auto theirs = other.nodes.nodes();
+        return lexicographical_compare(mine.begin(), mine.end(), theirs.begin(), theirs.end());
+    }
+
+    // Hash of the member set, see fingerprintNodes
+    uint64_t fingerprint() const {
+        auto view = nodes.nodes();
+        return fingerprintNodes(view.begin(), view.end());
     }
 
     void calculateWeights(shared_ptr<Graph<T>>& graph) {
         cachedGraphRef = graph;
+        cachedModificationCount = graph->getModificationCount();
+        weightsValid = true;
         
         // Reset weights before calculation
         internalWeight = 0.0;
         externalWeight = 0.0;
         
-        const auto& edges = graph->getEdgesWithWeight();
+        // Only the edges touching a member matter, so walk the members'
+        // neighbor lists instead of every edge in the graph
+        auto view = nodes.nodes();
+        unordered_set<T> members(view.begin(), view.end());
+        double localInternal = 0.0;
+        double localExternal = 0.0;
+        
+        for(const auto& node: view) {
+            if(!graph->hasVertex(node)) continue;
+            for(const auto& [neighbor, weight]: graph->getNeighbors(node)) {
+                if(members.count(neighbor)) {
+                    // internal edge, seen once from each endpoint
+                    // (a self-loop is listed twice in its own neighbors)
+                    localInternal += weight;
+                } else {
+                    // external edge, seen only from the member endpoint
+                    localExternal += weight;
+                }
+            }
+        }
+        
+        // Same scale as one pass over the edges: internal and external edge weights halved
+        internalWeight = localInternal / 4;
+        externalWeight = localExternal / 2;
+    }
+
+    // Internal and external weights of every community in one pass over the
+    // edges. Falls back to calculateWeights per community if they overlap.
+    static void calculateWeights(vector<Community<T, Storage>>& communities, shared_ptr<Graph<T>>& graph) {
+        unordered_map<T, int> nodeToCommunity;
+        for(size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for(const auto& node: communities[communityId].getNodes()) {
+                if(!nodeToCommunity.emplace(node, static_cast<int>(communityId)).second) {
+                    for(auto& community: communities) {
+                        community.calculateWeights(graph);
+                    }
+                    return;
+                }
+            }
+        }
+        
+        vector<double> internal(communities.size(), 0.0);
+        vector<double> external(communities.size(), 0.0);
         
-        for(const auto& [pair, weight]: edges) {
-            bool firstInCommunity = containsNode(pair.first);
-            bool secondInCommunity = containsNode(pair.second);
+        for(const auto& [pair, weight]: graph->getEdgesWithWeight()) {
+            auto first = nodeToCommunity.find(pair.first);
+            auto second = nodeToCommunity.find(pair.second);
+            int firstLabel = first == nodeToCommunity.end() ? -1 : first->second;
+            int secondLabel = second == nodeToCommunity.end() ? -1 : second->second;
             
-            if(firstInCommunity && secondInCommunity) {
-                // Both endpoints in community - internal edge
-                internalWeight += weight;
-            } else if(firstInCommunity || secondInCommunity) {
-                // Only one endpoint in community - external edge
-                externalWeight += weight;
+            if(firstLabel >= 0 && firstLabel == secondLabel) {
+                internal[firstLabel] += weight;
+            } else {
+                if(firstLabel >= 0) external[firstLabel] += weight;
+                if(secondLabel >= 0) external[secondLabel] += weight;
             }
-            // Ignore edges where neither endpoint is in the community
         }
         
-        internalWeight /= 2;
-        externalWeight /= 2;
+        for(size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            communities[communityId].cachedGraphRef = graph;
+            communities[communityId].cachedModificationCount = graph->getModificationCount();
+            communities[communityId].weightsValid = true;
+            communities[communityId].internalWeight = internal[communityId] / 2;
+            communities[communityId].externalWeight = external[communityId] / 2;
+        }
     }
 
     double getInternalWeight() const {
@@ -123,4 +259,12 @@ public:
 
 };
 
+// Hash for keying unordered containers by community
+template <typename T, typename Storage = SetStorage<T>>
+struct CommunityHash {
+    size_t operator()(const Community<T, Storage>& community) const {
+        return static_cast<size_t>(community.fingerprint());
+    }
+};
+
 #endif
\ No newline at end of file
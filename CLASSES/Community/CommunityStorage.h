@@ -0,0 +1,318 @@
+#ifndef COMMUNITYSTORAGE_H
+#define COMMUNITYSTORAGE_H
+
+#include <set>
+#include <vector>
+#include <algorithm>    // for set operations and lower_bound
+#include <iterator>     // for inserter
+#include <cstdint>      // for uint64_t
+#include <stdexcept>    // for exceptions
+#include <type_traits>  // for is_integral
+
+using namespace std;
+
+// Node storage policies for Community<T, Storage>.
+//
+// Every policy keeps its nodes in ascending order and offers insert,
+// insertRange, erase, contains, size, nodes() (an iterable view of the
+// members in order), insertAll (in-place union) and static unite / intersect.
+//
+//   SetStorage<T>          std::set, the default; works for any ordered T
+//   SortedVectorStorage<T> one contiguous sorted vector, no per-node overhead
+//   BitmapStorage<T>       one bit per id for non-negative integral ids;
+//                          union and intersection are word-wise OR / AND
+
+
+template <typename T>
+class SetStorage {
+private:
+    set<T> members;
+
+public:
+    using NodeView = const set<T>&;
+
+    void insert(const T& node) { members.insert(node); }
+
+    // Each node is inserted at the end hint, linear for sorted ranges
+    template <typename Iterator>
+    void insertRange(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            members.insert(members.end(), *first);
+        }
+    }
+
+    void erase(const T& node) { members.erase(node); }
+
+    bool contains(const T& node) const { return members.find(node) != members.end(); }
+
+    size_t size() const { return members.size(); }
+
+    NodeView nodes() const { return members; }
+
+    void insertAll(const SetStorage<T>& other) {
+        for (const auto& node : other.members) {
+            members.insert(node);
+        }
+    }
+
+    static void unite(const SetStorage<T>& a, const SetStorage<T>& b, SetStorage<T>& out) {
+        set_union(a.members.begin(), a.members.end(), b.members.begin(), b.members.end(),
+                  inserter(out.members, out.members.begin()));
+    }
+
+    static void intersect(const SetStorage<T>& a, const SetStorage<T>& b, SetStorage<T>& out) {
+        set_intersection(a.members.begin(), a.members.end(), b.members.begin(), b.members.end(),
+                         inserter(out.members, out.members.begin()));
+    }
+
+    bool operator==(const SetStorage<T>& other) const { return members == other.members; }
+};
+
+
+template <typename T>
+class SortedVectorStorage {
+private:
+    vector<T> members;  // sorted, no duplicates
+
+public:
+    using NodeView = const vector<T>&;
+
+    // Appending ids in increasing order is amortized O(1)
+    void insert(const T& node) {
+        if (members.empty() || members.back() < node) {
+            members.push_back(node);
+            return;
+        }
+        auto it = lower_bound(members.begin(), members.end(), node);
+        if (it == members.end() || *it != node) {
+            members.insert(it, node);
+        }
+    }
+
+    template <typename Iterator>
+    void insertRange(Iterator first, Iterator last) {
+        size_t oldSize = members.size();
+        members.insert(members.end(), first, last);
+        if (!is_sorted(members.begin() + oldSize, members.end())) {
+            sort(members.begin() + oldSize, members.end());
+        }
+        inplace_merge(members.begin(), members.begin() + oldSize, members.end());
+        members.erase(unique(members.begin(), members.end()), members.end());
+    }
+
+    void erase(const T& node) {
+        auto it = lower_bound(members.begin(), members.end(), node);
+        if (it != members.end() && *it == node) {
+            members.erase(it);
+        }
+    }
+
+    bool contains(const T& node) const { return binary_search(members.begin(), members.end(), node); }
+
+    size_t size() const { return members.size(); }
+
+    NodeView nodes() const { return members; }
+
+    void insertAll(const SortedVectorStorage<T>& other) {
+        SortedVectorStorage<T> merged;
+        unite(*this, other, merged);
+        members.swap(merged.members);
+    }
+
+    static void unite(const SortedVectorStorage<T>& a, const SortedVectorStorage<T>& b, SortedVectorStorage<T>& out) {
+        vector<T> result;
+        result.reserve(a.members.size() + b.members.size());
+        set_union(a.members.begin(), a.members.end(), b.members.begin(), b.members.end(), back_inserter(result));
+        out.members.swap(result);
+    }
+
+    // Branch-free merge step: both cursors advance by comparison results
+    // instead of taken branches, which keeps the loop free of mispredictions
+    static void intersect(const SortedVectorStorage<T>& a, const SortedVectorStorage<T>& b, SortedVectorStorage<T>& out) {
+        // one spare slot: a candidate is written before it is known to match
+        vector<T> result(min(a.members.size(), b.members.size()) + 1);
+        const T* x = a.members.data();
+        const T* xEnd = x + a.members.size();
+        const T* y = b.members.data();
+        const T* yEnd = y + b.members.size();
+        size_t count = 0;
+        while (x != xEnd && y != yEnd) {
+            T left = *x;
+            T right = *y;
+            result[count] = left;
+            count += !(left < right) && !(right < left);
+            x += !(right < left);
+            y += !(left < right);
+        }
+        result.resize(count);
+        out.members.swap(result);
+    }
+
+    bool operator==(const SortedVectorStorage<T>& other) const { return members == other.members; }
+};
+
+
+template <typename T>
+class BitmapStorage {
+    static_assert(is_integral<T>::value, "BitmapStorage needs integral node ids");
+
+private:
+    vector<uint64_t> words;  // bit i set <=> id i is a member
+    size_t count = 0;
+
+    static bool isNegative(const T& node) {
+        if constexpr (is_signed<T>::value) {
+            return node < 0;
+        } else {
+            return false;
+        }
+    }
+
+    static size_t indexOf(const T& node) {
+        if (isNegative(node)) {
+            throw std::invalid_argument("BitmapStorage needs non-negative node ids");
+        }
+        return static_cast<size_t>(node);
+    }
+
+    // drop trailing zero words so equal sets compare equal
+    void trim() {
+        while (!words.empty() && words.back() == 0) {
+            words.pop_back();
+        }
+    }
+
+public:
+    // Iterates the set bits in increasing id order
+    class NodeRange {
+    private:
+        const vector<uint64_t>* words;
+
+    public:
+        class iterator {
+        private:
+            const vector<uint64_t>* words;
+            size_t word;
+            uint64_t remaining;  // unvisited bits of the current word
+
+            void skipEmpty() {
+                while (remaining == 0 && word < words->size()) {
+                    ++word;
+                    remaining = word < words->size() ? (*words)[word] : 0;
+                }
+            }
+
+        public:
+            using iterator_category = forward_iterator_tag;
+            using value_type = T;
+            using difference_type = ptrdiff_t;
+            using pointer = const T*;
+            using reference = T;
+
+            iterator(const vector<uint64_t>* words, size_t word)
+                : words(words), word(word), remaining(word < words->size() ? (*words)[word] : 0) {
+                skipEmpty();
+            }
+
+            T operator*() const { return static_cast<T>(word * 64 + __builtin_ctzll(remaining)); }
+
+            iterator& operator++() {
+                remaining &= remaining - 1;
+                skipEmpty();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            bool operator==(const iterator& other) const {
+                return word == other.word && remaining == other.remaining;
+            }
+
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+        };
+
+        explicit NodeRange(const vector<uint64_t>* words) : words(words) {}
+
+        iterator begin() const { return iterator(words, 0); }
+
+        iterator end() const { return iterator(words, words->size()); }
+    };
+
+    using NodeView = NodeRange;
+
+    void insert(const T& node) {
+        size_t index = indexOf(node);
+        if (index / 64 >= words.size()) {
+            words.resize(index / 64 + 1, 0);
+        }
+        uint64_t bit = uint64_t(1) << (index % 64);
+        count += (words[index / 64] & bit) == 0;
+        words[index / 64] |= bit;
+    }
+
+    template <typename Iterator>
+    void insertRange(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    void erase(const T& node) {
+        if (isNegative(node) || static_cast<size_t>(node) / 64 >= words.size()) return;
+        size_t index = static_cast<size_t>(node);
+        uint64_t bit = uint64_t(1) << (index % 64);
+        count -= (words[index / 64] & bit) != 0;
+        words[index / 64] &= ~bit;
+        trim();
+    }
+
+    bool contains(const T& node) const {
+        if (isNegative(node) || static_cast<size_t>(node) / 64 >= words.size()) return false;
+        size_t index = static_cast<size_t>(node);
+        return (words[index / 64] >> (index % 64)) & 1;
+    }
+
+    size_t size() const { return count; }
+
+    NodeView nodes() const { return NodeRange(&words); }
+
+    void insertAll(const BitmapStorage<T>& other) {
+        if (other.words.size() > words.size()) {
+            words.resize(other.words.size(), 0);
+        }
+        size_t total = 0;
+        for (size_t i = 0; i < other.words.size(); ++i) {
+            words[i] |= other.words[i];
+        }
+        for (uint64_t word : words) {
+            total += __builtin_popcountll(word);
+        }
+        count = total;
+    }
+
+    static void unite(const BitmapStorage<T>& a, const BitmapStorage<T>& b, BitmapStorage<T>& out) {
+        BitmapStorage<T> result = a;
+        result.insertAll(b);
+        out = move(result);
+    }
+
+    static void intersect(const BitmapStorage<T>& a, const BitmapStorage<T>& b, BitmapStorage<T>& out) {
+        vector<uint64_t> result(min(a.words.size(), b.words.size()));
+        size_t total = 0;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i] = a.words[i] & b.words[i];
+            total += __builtin_popcountll(result[i]);
+        }
+        out.words.swap(result);
+        out.count = total;
+        out.trim();
+    }
+
+    bool operator==(const BitmapStorage<T>& other) const { return words == other.words; }
+};
+
+#endif
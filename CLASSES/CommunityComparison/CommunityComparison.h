@@ -16,49 +16,95 @@
 #include <map>           // For std::map
 #include <cmath>         // For log2
 #include <algorithm>     // For sort
+#include <type_traits>   // For is_integral
+#include <thread>        // For batch comparisons
+#include <atomic>        // For the batch work counter
+#include <exception>     // For exception_ptr
+#include <mutex>         // For the batch failure lock
 #include "../Community/Community.h"
+#include "ContingencyTable.h"
+#include "CoverOverlap.h"
+#include "../FileParsing/FileParsing.h"
 template <typename T> 
 class CommunityComparison {
 private:
     std::map<T, int, std::less<T>, std::allocator<std::pair<const T, int>>> nodeToTrueCommunity; // Maps each node to its ground truth community ID
     std::map<T, int, std::less<T>, std::allocator<std::pair<const T, int>>> nodeToPredCommunity; // Maps each node to its predicted community ID
 
+    // Ground truth indexed once by prepareGroundTruth: first community of each
+    // node, through a dense array for small non-negative integral ids
+    bool groundTruthPrepared = false;
+    bool groundTruthDense = false;
+    vector<int> groundTruthById;
+    unordered_map<T, int> groundTruthIndex;
+
 public:
 
+    /**
+     * Reads "node community" lines into two flat arrays, one entry per line,
+     * with chunked reads and from_chars. Lines that do not start with a node
+     * and an integer community id are skipped.
+     * @param filename Community file
+     * @return Pair of (nodes, community ids), aligned by line
+     */
+    pair<vector<T>, vector<int>> loadCommunityLabels(const string& filename) {
+        ChunkedLineReader reader(filename);
+        pair<vector<T>, vector<int>> labels;
+        const char* lineBegin;
+        const char* lineEnd;
+        T nodeId;
+        int communityId;
+
+        while (reader.nextLine(lineBegin, lineEnd)) {
+            const char* p = lineBegin;
+            if (parseToken(p, lineEnd, nodeId) && parseToken(p, lineEnd, communityId)) {
+                labels.first.push_back(nodeId);
+                labels.second.push_back(communityId);
+            }
+        }
+        return labels;
+    }
+
+    /**
+     * Loads communities from "node community" lines, one community per
+     * distinct community id in ascending id order. The lines are parsed into
+     * flat arrays and grouped by a counting sort, and every community is
+     * built from its sorted nodes in place.
+     * @param filename Community file
+     * @return Communities
+     */
     vector<Community<T>> loadCommunities(string filename) {
-        ifstream myfile(filename);
-        
-        if (!myfile.is_open()) {
-            throw runtime_error("Could not open file: " + filename);
+        auto [nodes, labels] = loadCommunityLabels(filename);
+
+        // rank the community ids
+        vector<int> distinct(labels);
+        sort(distinct.begin(), distinct.end());
+        distinct.erase(unique(distinct.begin(), distinct.end()), distinct.end());
+        vector<size_t> start(distinct.size() + 1, 0);
+        for (int& label : labels) {
+            label = static_cast<int>(lower_bound(distinct.begin(), distinct.end(), label) - distinct.begin());
+            ++start[label + 1];
+        }
+        for (size_t c = 0; c < distinct.size(); ++c) {
+            start[c + 1] += start[c];
         }
 
-        std::map<int, Community<T>, std::less<int>, std::allocator<std::pair<const int, Community<T>>>> communityMap;
-        
-        string line;
-        while (getline(myfile, line)) {
-            
-            istringstream iss(line);
-            T nodeId;
-            int communityId;
-            
-            if (!(iss >> nodeId >> communityId)) {
-                continue; 
-            }
-            
-        
-            if (communityMap.find(communityId) == communityMap.end()) {
-                communityMap[communityId] = Community<T>();
-            }
-            
-            communityMap[communityId].addNode(nodeId);
+        // group the nodes by community
+        vector<T> grouped(nodes.size());
+        vector<size_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            grouped[fill[labels[i]]++] = move(nodes[i]);
         }
-        
-        vector<Community<T>> communities;
-        for (const auto& pair : communityMap) {
-            communities.push_back(pair.second);
+        vector<T>().swap(nodes);
+        vector<int>().swap(labels);
+
+        vector<Community<T>> communities(distinct.size());
+        for (size_t c = 0; c < distinct.size(); ++c) {
+            auto first = grouped.begin() + start[c];
+            auto last = grouped.begin() + start[c + 1];
+            sort(first, last);
+            communities[c].addNodes(first, last);
         }
-        
-        myfile.close();
         return communities;
     }
     
@@ -109,67 +155,43 @@ public:
         return commonNodes;
     }
 
-    pair<vector<int>, vector<int>> convertCommunitiesToLabelVectors(vector<Community<T>>& trueCommunities, vector<Community<T>>& predCommunities) {
-        
-        set<T> trueCommunityNodes;
-        set<T> predictedCommunityNodes;
-
-
-        set<T> trueNodes = getNodeSet(trueCommunities);
-        set<T> predNodes = getNodeSet(predCommunities);
-
-        set<T> commonNodes;
-
-        for(const auto& node: trueNodes) {
-            if(predNodes.find(node) != predNodes.end()) {
-                commonNodes.insert(node);
+    /**
+     * Builds aligned label vectors over the nodes present in both partitions
+     * (in ascending node order). A node in several communities takes the
+     * label of the first one; use calculateOverlappingNMI to score covers
+     * with overlapping communities. Runs in O(N) with a dense array for small
+     * non-negative integral ids, and with hash maps otherwise.
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @return Pair of label vectors (true, predicted)
+     */
+    pair<vector<int>, vector<int>> convertCommunitiesToLabelVectors(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) {
+        if constexpr (is_integral<T>::value) {
+            pair<vector<int>, vector<int>> labels;
+            if (convertWithDenseIndex(trueCommunities, predCommunities, labels)) {
+                return labels;
             }
         }
 
-        vector<pair<T, int>> trueMappings;
-        for (const T& commonNode : commonNodes) {
-            for (size_t communityId = 0; communityId < trueCommunities.size(); communityId++) {
-                const Community<T>& community = trueCommunities[communityId];
-                if (community.containsNode(commonNode)) {
-                    trueMappings.push_back(make_pair(commonNode, communityId));
-                    break;  
-                }
-            }
-        }
+        unordered_map<T, int> trueIndex = indexFirstCommunity(trueCommunities);
+        unordered_map<T, int> predIndex = indexFirstCommunity(predCommunities);
 
-        vector<pair<T,int>> predMappings;
-        for(const T& commonNode: commonNodes) {
-            for(size_t communityId2 = 0; communityId2 < predCommunities.size(); communityId2++) {
-                const Community<T>& community = predCommunities[communityId2];
-                if(community.containsNode(commonNode)) {
-                    predMappings.push_back(make_pair(commonNode,communityId2));
-                    break;
-                }
+        vector<T> commonNodes;
+        commonNodes.reserve(min(trueIndex.size(), predIndex.size()));
+        for (const auto& [node, label] : trueIndex) {
+            if (predIndex.find(node) != predIndex.end()) {
+                commonNodes.push_back(node);
             }
         }
-        
-        // Create a map to ensure consistent ordering of nodes
-        std::map<T, int, std::less<T>, std::allocator<std::pair<const T, int>>> nodeIndexMap;
-        int index = 0;
-        for(const auto& node : commonNodes) {
-            nodeIndexMap[node] = index++;
-        }
-        
-        // Initialize the label vectors with the size of common nodes
-        vector<int> trueLabels(commonNodes.size(), -1);
-        vector<int> predLabels(commonNodes.size(), -1);
-        
-        // Fill the label vectors based on the mappings
-        for(const auto& mapping : trueMappings) {
-            int nodeIndex = nodeIndexMap[mapping.first];
-            trueLabels[nodeIndex] = mapping.second;
-        }
-        
-        for(const auto& mapping : predMappings) {
-            int nodeIndex = nodeIndexMap[mapping.first];
-            predLabels[nodeIndex] = mapping.second;
+        sort(commonNodes.begin(), commonNodes.end());
+
+        vector<int> trueLabels(commonNodes.size());
+        vector<int> predLabels(commonNodes.size());
+        for (size_t i = 0; i < commonNodes.size(); i++) {
+            trueLabels[i] = trueIndex.at(commonNodes[i]);
+            predLabels[i] = predIndex.at(commonNodes[i]);
         }
-        
+
         return make_pair(trueLabels, predLabels);
     }
     
@@ -181,9 +203,7 @@ public:
      */
     double calculateNMI(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) {
         // Convert communities to label vectors
-        vector<Community<T>> trueCommsCopy = trueCommunities;
-        vector<Community<T>> predCommsCopy = predCommunities;
-        auto labelVectors = convertCommunitiesToLabelVectors(trueCommsCopy, predCommsCopy);
+        auto labelVectors = convertCommunitiesToLabelVectors(trueCommunities, predCommunities);
         
         vector<int>& trueLabels = labelVectors.first;
         vector<int>& predLabels = labelVectors.second;
@@ -192,6 +212,55 @@ public:
         return normalizedMutualInfo(trueLabels, predLabels);
     }
     
+    /**
+     * Calculates NMI, ARI, AMI, VI and best-match F1 from one contingency
+     * table over the nodes present in both partitions
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @return All similarity metrics
+     */
+    PartitionMetrics calculateMetrics(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) {
+        auto labelVectors = convertCommunitiesToLabelVectors(trueCommunities, predCommunities);
+        return ContingencyTable(labelVectors.first, labelVectors.second).allMetrics();
+    }
+    
+    /**
+     * Intersection counts of two covers whose communities may overlap. The
+     * nodes are those of either cover; a node missing from one cover is in
+     * none of its communities. Empty communities are left out.
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @return Sparse cover intersections
+     */
+    CoverOverlap buildCoverOverlap(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) const {
+        vector<vector<uint32_t>> trueCover, predCover;
+        size_t numNodes = indexCovers(trueCommunities, predCommunities, trueCover, predCover);
+        return CoverOverlap(numNodes, trueCover, predCover);
+    }
+
+    /**
+     * Overlapping NMI of McDaid et al. (2011), normalized by the larger cover
+     * entropy. Equals 1 only for identical covers and reduces to a sensible
+     * score when neither cover overlaps.
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @return NMI value between 0 and 1
+     */
+    double calculateOverlappingNMI(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) const {
+        return buildCoverOverlap(trueCommunities, predCommunities).mcdaidNMI();
+    }
+
+    /**
+     * Overlapping NMI of Lancichinetti, Fortunato and Kertesz (2009), as
+     * reported by the LFR benchmark tools
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @return NMI value between 0 and 1
+     */
+    double calculateLFKNMI(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities) const {
+        return buildCoverOverlap(trueCommunities, predCommunities).lfkNMI();
+    }
+
     /**
      * Creates a mapping from nodes to their community IDs
      * @param communities Vector of communities
@@ -347,57 +416,10 @@ public:
      * @return NMI value between 0 and 1
      */
     double normalizedMutualInfo(const vector<int>& labels_true, const vector<int>& labels_pred) {
-        // Count occurrences of each label
-        std::map<int, int, std::less<int>, std::allocator<std::pair<const int, int>>> trueCounts;
-        std::map<int, int, std::less<int>, std::allocator<std::pair<const int, int>>> predCounts;
-        std::map<pair<int, int>, int, std::less<pair<int, int>>, std::allocator<std::pair<const pair<int, int>, int>>> jointCounts;
-        
-        for (size_t i = 0; i < labels_true.size(); i++) {
-            int trueLabel = labels_true[i];
-            int predLabel = labels_pred[i];
-            
-            trueCounts[trueLabel]++;
-            predCounts[predLabel]++;
-            jointCounts[make_pair(trueLabel, predLabel)]++;
-        }
-        
-        // Calculate probabilities
-        double n = static_cast<double>(labels_true.size());
-        vector<double> p_true, p_pred, p_joint;
-        
-        for (const auto& pair : trueCounts) {
-            p_true.push_back(pair.second / n);
-        }
-        
-        for (const auto& pair : predCounts) {
-            p_pred.push_back(pair.second / n);
-        }
-        
-        for (const auto& pair : jointCounts) {
-            p_joint.push_back(pair.second / n);
-        }
-        
-        // Calculate entropies
-        double h_true = shannonEntropy(p_true);
-        double h_pred = shannonEntropy(p_pred);
-        
-        // Calculate joint entropy
-        double h_joint = 0;
-        for (const auto& p : p_joint) {
-            if (p > 0) {
-                h_joint -= p * log2(p);
-            }
-        }
-        
-        // Calculate mutual information
-        double mi = h_true + h_pred - h_joint;
-        
-        // Calculate normalized mutual information
-        if (h_true + h_pred == 0) {
-            return 0;
-        }
-        
-        return 2 * mi / (h_true + h_pred);
+        // Flat marginal counts and a sparse joint table, summed in ascending
+        // label order (see ContingencyTable.h)
+        ContingencyTable table(labels_true, labels_pred);
+        return table.normalizedMutualInformation();
     }
     
     /**
@@ -415,7 +437,325 @@ public:
         return entropy;
     }
 
-    
+    /**
+     * Result of comparing one predicted partition with the prepared ground truth
+     */
+    struct PartitionComparison {
+        string name;            // file name, or the index for in-memory partitions
+        size_t numCommunities;  // communities in the predicted partition
+        size_t commonNodes;     // nodes present in both partitions
+        double nmi;
+        double ari;
+        double ami;
+        double vi;
+        double f1;
+    };
+
+    /**
+     * Indexes the ground truth once so that many predicted partitions can be
+     * scored against it without rebuilding its node set and labels
+     * @param trueCommunities Vector of true communities
+     */
+    void prepareGroundTruth(const vector<Community<T>>& trueCommunities) {
+        groundTruthById.clear();
+        groundTruthIndex.clear();
+
+        groundTruthDense = false;
+        if constexpr (is_integral<T>::value) {
+            T maxId;
+            groundTruthDense = fitsDenseIndex({&trueCommunities}, maxId);
+            if (groundTruthDense) {
+                groundTruthById.assign(static_cast<size_t>(maxId) + 1, -1);
+                for (size_t communityId = 0; communityId < trueCommunities.size(); communityId++) {
+                    for (const T& node : trueCommunities[communityId].getNodes()) {
+                        int& slot = groundTruthById[static_cast<size_t>(node)];
+                        if (slot < 0) slot = static_cast<int>(communityId);
+                    }
+                }
+            }
+        }
+        if (!groundTruthDense) {
+            groundTruthIndex = indexFirstCommunity(trueCommunities);
+        }
+        groundTruthPrepared = true;
+    }
+
+    bool hasGroundTruth() const { return groundTruthPrepared; }
+
+    /**
+     * Label vectors of a predicted partition against the prepared ground
+     * truth. Same labels as convertCommunitiesToLabelVectors; the nodes are
+     * in the order they are found, which does not change any score.
+     * @param predCommunities Vector of predicted communities
+     * @return Pair of label vectors (true, predicted)
+     */
+    pair<vector<int>, vector<int>> labelVectorsAgainstGroundTruth(const vector<Community<T>>& predCommunities) const {
+        if (!groundTruthPrepared) {
+            throw logic_error("Ground truth has not been prepared");
+        }
+        pair<vector<int>, vector<int>> labels;
+        if (!groundTruthDense) {
+            unordered_set<T> seen;
+            for (size_t communityId = 0; communityId < predCommunities.size(); communityId++) {
+                for (const T& node : predCommunities[communityId].getNodes()) {
+                    auto truth = groundTruthIndex.find(node);
+                    if (truth != groundTruthIndex.end() && seen.insert(node).second) {
+                        labels.first.push_back(truth->second);
+                        labels.second.push_back(static_cast<int>(communityId));
+                    }
+                }
+            }
+            return labels;
+        }
+
+        if constexpr (is_integral<T>::value) {
+            vector<char> seen(groundTruthById.size(), 0);
+            for (size_t communityId = 0; communityId < predCommunities.size(); communityId++) {
+                for (const T& node : predCommunities[communityId].getNodes()) {
+                    if constexpr (is_signed<T>::value) {
+                        if (node < 0) continue;
+                    }
+                    size_t id = static_cast<size_t>(node);
+                    if (id >= groundTruthById.size()) continue;
+                    if (groundTruthById[id] >= 0 && !seen[id]) {
+                        seen[id] = 1;
+                        labels.first.push_back(groundTruthById[id]);
+                        labels.second.push_back(static_cast<int>(communityId));
+                    }
+                }
+            }
+        }
+        return labels;
+    }
+
+    /**
+     * NMI of a predicted partition against the prepared ground truth,
+     * identical to calculateNMI(trueCommunities, predCommunities)
+     * @param predCommunities Vector of predicted communities
+     * @return NMI value between 0 and 1
+     */
+    double calculateNMIToGroundTruth(const vector<Community<T>>& predCommunities) const {
+        auto labels = labelVectorsAgainstGroundTruth(predCommunities);
+        return ContingencyTable(labels.first, labels.second).normalizedMutualInformation();
+    }
+
+    /**
+     * Scores many predicted partitions against the prepared ground truth
+     * (NMI, ARI, AMI, VI and F1 for each)
+     * @param predictions Predicted partitions
+     * @param numThreads Worker threads, 0 for every hardware thread
+     * @return One row per partition, in input order
+     */
+    vector<PartitionComparison> batchCalculateNMI(const vector<vector<Community<T>>>& predictions, unsigned numThreads = 0) const {
+        vector<PartitionComparison> results(predictions.size());
+        runBatch(predictions.size(), numThreads, [&](size_t i) {
+            results[i] = comparePartition(to_string(i), predictions[i]);
+        });
+        return results;
+    }
+
+    /**
+     * Loads and scores many predicted community files ("node community"
+     * lines) against the prepared ground truth. Files are loaded by the
+     * worker threads, so only one partition per thread is held in memory.
+     * @param predictionFiles Predicted community files
+     * @param numThreads Worker threads, 0 for every hardware thread
+     * @return One row per file, in input order
+     */
+    vector<PartitionComparison> batchCalculateNMI(const vector<string>& predictionFiles, unsigned numThreads = 0) const {
+        vector<PartitionComparison> results(predictionFiles.size());
+        runBatch(predictionFiles.size(), numThreads, [&](size_t i) {
+            CommunityComparison<T> loader;
+            results[i] = comparePartition(predictionFiles[i], loader.loadCommunities(predictionFiles[i]));
+        });
+        return results;
+    }
+
+private:
+    /**
+     * Maps every node to the first community that contains it
+     * @param communities Vector of communities
+     * @return Map from nodes to community IDs
+     */
+    unordered_map<T, int> indexFirstCommunity(const vector<Community<T>>& communities) const {
+        size_t memberships = 0;
+        for (const auto& community : communities) {
+            memberships += community.size();
+        }
+
+        unordered_map<T, int> index;
+        index.reserve(memberships);
+        for (size_t communityId = 0; communityId < communities.size(); communityId++) {
+            for (const T& node : communities[communityId].getNodes()) {
+                index.emplace(node, static_cast<int>(communityId));
+            }
+        }
+        return index;
+    }
+
+    /**
+     * Label vectors through arrays indexed by node id. Only used when all ids
+     * are non-negative and the largest id is within a small multiple of the
+     * number of memberships.
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @param labels Output pair of label vectors
+     * @return false if the ids are too sparse or negative
+     */
+    bool convertWithDenseIndex(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities,
+                               pair<vector<int>, vector<int>>& labels) const {
+        T maxId;
+        if (!fitsDenseIndex({&trueCommunities, &predCommunities}, maxId)) {
+            return false;
+        }
+
+        size_t range = static_cast<size_t>(maxId) + 1;
+        vector<int> trueById(range, -1);
+        vector<int> predById(range, -1);
+        for (size_t communityId = 0; communityId < trueCommunities.size(); communityId++) {
+            for (const T& node : trueCommunities[communityId].getNodes()) {
+                int& slot = trueById[static_cast<size_t>(node)];
+                if (slot < 0) slot = static_cast<int>(communityId);
+            }
+        }
+        for (size_t communityId = 0; communityId < predCommunities.size(); communityId++) {
+            for (const T& node : predCommunities[communityId].getNodes()) {
+                int& slot = predById[static_cast<size_t>(node)];
+                if (slot < 0) slot = static_cast<int>(communityId);
+            }
+        }
+
+        labels.first.clear();
+        labels.second.clear();
+        for (size_t id = 0; id < range; id++) {
+            if (trueById[id] >= 0 && predById[id] >= 0) {
+                labels.first.push_back(trueById[id]);
+                labels.second.push_back(predById[id]);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Replaces the nodes of both covers by dense indices over their union
+     * @param trueCommunities Vector of true communities
+     * @param predCommunities Vector of predicted communities
+     * @param trueCover Output clusters of node indices, empty communities left out
+     * @param predCover Output clusters of node indices, empty communities left out
+     * @return Number of distinct nodes
+     */
+    size_t indexCovers(const vector<Community<T>>& trueCommunities, const vector<Community<T>>& predCommunities,
+                       vector<vector<uint32_t>>& trueCover, vector<vector<uint32_t>>& predCover) const {
+        uint32_t numNodes = 0;
+        auto fill = [&](const vector<Community<T>>& communities, vector<vector<uint32_t>>& cover, auto&& indexOf) {
+            cover.clear();
+            for (const auto& community : communities) {
+                if (community.size() == 0) continue;
+                cover.emplace_back();
+                cover.back().reserve(community.size());
+                for (const T& node : community.getNodes()) {
+                    cover.back().push_back(indexOf(node));
+                }
+            }
+        };
+
+        if constexpr (is_integral<T>::value) {
+            T maxId;
+            if (fitsDenseIndex({&trueCommunities, &predCommunities}, maxId)) {
+                vector<uint32_t> indexById(static_cast<size_t>(maxId) + 1, UINT32_MAX);
+                auto indexOf = [&](const T& node) {
+                    uint32_t& slot = indexById[static_cast<size_t>(node)];
+                    if (slot == UINT32_MAX) slot = numNodes++;
+                    return slot;
+                };
+                fill(trueCommunities, trueCover, indexOf);
+                fill(predCommunities, predCover, indexOf);
+                return numNodes;
+            }
+        }
+
+        unordered_map<T, uint32_t> indexByNode;
+        auto indexOf = [&](const T& node) {
+            auto inserted = indexByNode.emplace(node, numNodes);
+            if (inserted.second) ++numNodes;
+            return inserted.first->second;
+        };
+        fill(trueCommunities, trueCover, indexOf);
+        fill(predCommunities, predCover, indexOf);
+        return numNodes;
+    }
+
+    /**
+     * Whether all ids are non-negative and the largest id is within a small
+     * multiple of the number of memberships
+     * @param partitions Partitions whose ids are checked
+     * @param maxId Output largest id
+     * @return true if a dense id array is worth it
+     */
+    bool fitsDenseIndex(initializer_list<const vector<Community<T>>*> partitions, T& maxId) const {
+        size_t memberships = 0;
+        maxId = T();
+        for (const auto* communities : partitions) {
+            for (const auto& community : *communities) {
+                if (community.size() == 0) continue;
+                memberships += community.size();
+                // nodes are kept in ascending order
+                if constexpr (is_signed<T>::value) {
+                    if (*community.getNodes().begin() < 0) {
+                        return false;
+                    }
+                }
+                maxId = max(maxId, *community.getNodes().rbegin());
+            }
+        }
+        return static_cast<unsigned long long>(maxId) <= 4 * static_cast<unsigned long long>(memberships) + 1024;
+    }
+
+    PartitionComparison comparePartition(const string& name, const vector<Community<T>>& predCommunities) const {
+        auto labels = labelVectorsAgainstGroundTruth(predCommunities);
+        PartitionMetrics metrics = ContingencyTable(labels.first, labels.second).allMetrics();
+        return PartitionComparison{name, predCommunities.size(), labels.first.size(),
+                                   metrics.nmi, metrics.ari, metrics.ami, metrics.vi, metrics.f1};
+    }
+
+    /**
+     * Runs task(0) ... task(count - 1) on a pool of threads; the first
+     * exception thrown by a task is rethrown after all threads finish
+     */
+    template <typename Task>
+    static void runBatch(size_t count, unsigned numThreads, Task task) {
+        unsigned threads = numThreads == 0 ? max(1u, thread::hardware_concurrency()) : numThreads;
+        threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(count, 1)));
+
+        atomic<size_t> next(0);
+        exception_ptr failure;
+        mutex failureLock;
+        auto work = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                try {
+                    task(i);
+                } catch (...) {
+                    lock_guard<mutex> guard(failureLock);
+                    if (!failure) failure = current_exception();
+                }
+            }
+        };
+
+        if (threads <= 1) {
+            work();
+        } else {
+            vector<thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back(work);
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        if (failure) {
+            rethrow_exception(failure);
+        }
+    }
 };
 
 
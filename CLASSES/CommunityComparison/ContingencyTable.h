@@ -0,0 +1,411 @@
+#ifndef CONTINGENCYTABLE_H
+#define CONTINGENCYTABLE_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>       // For uint64_t
+#include <stdexcept>     // For exceptions
+#include <algorithm>     // For sort, unique, lower_bound
+#include <cmath>         // For log2
+using namespace std;
+
+
+/**
+ * Similarity scores of two partitions derived from one contingency table
+ */
+struct PartitionMetrics {
+    double nmi;  // normalized mutual information, arithmetic mean normalization
+    double ari;  // adjusted Rand index
+    double ami;  // adjusted mutual information, arithmetic mean normalization
+    double vi;   // variation of information in bits (0 for identical partitions)
+    double f1;   // best-match F1, averaged over both directions
+};
+
+
+/**
+ * Contingency table of two label vectors over the same samples.
+ *
+ * Labels are first mapped to dense indices in ascending label order. The row
+ * and column sums are kept in flat arrays. The non-zero joint counts go into
+ * a flat 2D array when rows x columns is small, and into an open-addressing
+ * hash table otherwise. Either way they are exposed as cells sorted by
+ * (row, column). Because every sum runs in ascending label order, the
+ * entropies match the std::map based computation bit for bit.
+ */
+class ContingencyTable {
+public:
+    struct Cell {
+        uint32_t row;
+        uint32_t column;
+        uint64_t count;
+    };
+
+private:
+    size_t sampleCount = 0;
+    vector<uint64_t> rowSums;     // per distinct label of the first vector, ascending
+    vector<uint64_t> columnSums;  // per distinct label of the second vector, ascending
+    vector<Cell> cells;           // non-zero joint counts sorted by (row, column)
+
+    // Largest joint table kept as a flat array (32 MB of counts)
+    static constexpr uint64_t maxDenseCells = uint64_t(1) << 22;
+
+    /**
+     * Replaces labels by their rank among the distinct labels
+     * @param labels Input labels
+     * @param indices Output dense indices, one per sample
+     * @return Number of distinct labels
+     */
+    static uint32_t denseIndices(const vector<int>& labels, vector<uint32_t>& indices) {
+        indices.resize(labels.size());
+        if (labels.empty()) {
+            return 0;
+        }
+        auto [minIt, maxIt] = minmax_element(labels.begin(), labels.end());
+        int64_t low = *minIt;
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(*maxIt) - low) + 1;
+
+        if (range <= 4 * static_cast<uint64_t>(labels.size()) + 1024) {
+            // offset array over the label range, unused labels get no index
+            vector<uint32_t> rank(range, 0);
+            for (int label : labels) {
+                rank[static_cast<int64_t>(label) - low] = 1;
+            }
+            uint32_t next = 0;
+            for (auto& slot : rank) {
+                slot = slot ? next++ : UINT32_MAX;
+            }
+            for (size_t i = 0; i < labels.size(); ++i) {
+                indices[i] = rank[static_cast<int64_t>(labels[i]) - low];
+            }
+            return next;
+        }
+
+        // sparse labels: rank through the sorted distinct values
+        vector<int> distinct(labels);
+        sort(distinct.begin(), distinct.end());
+        distinct.erase(unique(distinct.begin(), distinct.end()), distinct.end());
+        for (size_t i = 0; i < labels.size(); ++i) {
+            indices[i] = static_cast<uint32_t>(lower_bound(distinct.begin(), distinct.end(), labels[i]) - distinct.begin());
+        }
+        return static_cast<uint32_t>(distinct.size());
+    }
+
+    void countDense(const vector<uint32_t>& rows, const vector<uint32_t>& columns) {
+        size_t numColumns = columnSums.size();
+        vector<uint64_t> joint(rowSums.size() * numColumns, 0);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            ++joint[rows[i] * numColumns + columns[i]];
+        }
+        for (size_t key = 0; key < joint.size(); ++key) {
+            if (joint[key] > 0) {
+                cells.push_back({static_cast<uint32_t>(key / numColumns), static_cast<uint32_t>(key % numColumns), joint[key]});
+            }
+        }
+    }
+
+    // Open addressing with linear probing; keys are row * columns + column + 1
+    // so that 0 marks an empty slot
+    void countHashed(const vector<uint32_t>& rows, const vector<uint32_t>& columns) {
+        uint64_t numColumns = columnSums.size();
+        size_t capacity = 1024;
+        vector<uint64_t> keys(capacity, 0);
+        vector<uint64_t> counts(capacity, 0);
+        size_t used = 0;
+
+        auto slotOf = [](uint64_t key, size_t mask) {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+        };
+
+        auto grow = [&]() {
+            vector<uint64_t> oldKeys(capacity * 2, 0);
+            vector<uint64_t> oldCounts(capacity * 2, 0);
+            oldKeys.swap(keys);
+            oldCounts.swap(counts);
+            capacity *= 2;
+            for (size_t s = 0; s < oldKeys.size(); ++s) {
+                if (oldKeys[s] == 0) continue;
+                size_t target = slotOf(oldKeys[s], capacity - 1);
+                while (keys[target] != 0) {
+                    target = (target + 1) & (capacity - 1);
+                }
+                keys[target] = oldKeys[s];
+                counts[target] = oldCounts[s];
+            }
+        };
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            uint64_t key = rows[i] * numColumns + columns[i] + 1;
+            size_t slot = slotOf(key, capacity - 1);
+            while (keys[slot] != 0 && keys[slot] != key) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (keys[slot] == key) {
+                ++counts[slot];
+                continue;
+            }
+            keys[slot] = key;
+            counts[slot] = 1;
+            if (++used * 2 > capacity) {
+                // keep the load at most one half
+                grow();
+            }
+        }
+
+        vector<pair<uint64_t, uint64_t>> entries;
+        entries.reserve(used);
+        for (size_t s = 0; s < capacity; ++s) {
+            if (keys[s] != 0) {
+                entries.emplace_back(keys[s] - 1, counts[s]);
+            }
+        }
+        sort(entries.begin(), entries.end());
+        cells.reserve(entries.size());
+        for (const auto& [key, count] : entries) {
+            cells.push_back({static_cast<uint32_t>(key / numColumns), static_cast<uint32_t>(key % numColumns), count});
+        }
+    }
+
+    // n choose 2 as a double
+    static double pairs(uint64_t n) {
+        return 0.5 * static_cast<double>(n) * (static_cast<double>(n) - 1);
+    }
+
+    // Distinct values of counts with their multiplicities
+    static vector<pair<uint64_t, uint64_t>> groupSizes(const vector<uint64_t>& counts) {
+        vector<uint64_t> sorted(counts);
+        sort(sorted.begin(), sorted.end());
+        vector<pair<uint64_t, uint64_t>> groups;
+        for (uint64_t size : sorted) {
+            if (!groups.empty() && groups.back().first == size) {
+                ++groups.back().second;
+            } else {
+                groups.emplace_back(size, 1);
+            }
+        }
+        return groups;
+    }
+
+    static double entropy(const vector<uint64_t>& counts, double n) {
+        double h = 0;
+        for (uint64_t count : counts) {
+            double p = count / n;
+            if (p > 0) {
+                h -= p * log2(p);
+            }
+        }
+        return h;
+    }
+
+public:
+    /**
+     * Builds the table of two label vectors
+     * @param labels1 First labels (rows)
+     * @param labels2 Second labels (columns), same length as labels1
+     */
+    ContingencyTable(const vector<int>& labels1, const vector<int>& labels2) {
+        if (labels1.size() != labels2.size()) {
+            throw invalid_argument("Label vectors must have the same length");
+        }
+        sampleCount = labels1.size();
+
+        vector<uint32_t> rows, columns;
+        rowSums.assign(denseIndices(labels1, rows), 0);
+        columnSums.assign(denseIndices(labels2, columns), 0);
+        for (size_t i = 0; i < sampleCount; ++i) {
+            ++rowSums[rows[i]];
+            ++columnSums[columns[i]];
+        }
+
+        uint64_t jointSize = static_cast<uint64_t>(rowSums.size()) * columnSums.size();
+        if (jointSize <= maxDenseCells && jointSize <= 4 * static_cast<uint64_t>(sampleCount) + 1024) {
+            countDense(rows, columns);
+        } else {
+            countHashed(rows, columns);
+        }
+    }
+
+    size_t getSampleCount() const { return sampleCount; }
+
+    const vector<uint64_t>& getRowSums() const { return rowSums; }
+
+    const vector<uint64_t>& getColumnSums() const { return columnSums; }
+
+    const vector<Cell>& getCells() const { return cells; }
+
+    double rowEntropy() const { return entropy(rowSums, static_cast<double>(sampleCount)); }
+
+    double columnEntropy() const { return entropy(columnSums, static_cast<double>(sampleCount)); }
+
+    double jointEntropy() const {
+        double n = static_cast<double>(sampleCount);
+        double h = 0;
+        for (const Cell& cell : cells) {
+            double p = cell.count / n;
+            if (p > 0) {
+                h -= p * log2(p);
+            }
+        }
+        return h;
+    }
+
+    double mutualInformation() const {
+        return rowEntropy() + columnEntropy() - jointEntropy();
+    }
+
+    /**
+     * NMI with arithmetic-mean normalization, 2 I / (H1 + H2)
+     * @return NMI value between 0 and 1, 0 if both entropies are 0
+     */
+    double normalizedMutualInformation() const {
+        double h1 = rowEntropy();
+        double h2 = columnEntropy();
+        double mi = h1 + h2 - jointEntropy();
+        if (h1 + h2 == 0) {
+            return 0;
+        }
+        return 2 * mi / (h1 + h2);
+    }
+
+    /**
+     * Adjusted Rand index (Hubert and Arabie 1985)
+     * @return ARI, 1 for identical partitions and about 0 for random ones
+     */
+    double adjustedRandIndex() const {
+        double index = 0, rowPairs = 0, columnPairs = 0;
+        for (const Cell& cell : cells) index += pairs(cell.count);
+        for (uint64_t count : rowSums) rowPairs += pairs(count);
+        for (uint64_t count : columnSums) columnPairs += pairs(count);
+
+        double total = pairs(sampleCount);
+        double expected = total > 0 ? rowPairs * columnPairs / total : 0;
+        double maximum = (rowPairs + columnPairs) / 2;
+        if (maximum == expected) {
+            // both partitions are all singletons or a single cluster
+            return 1.0;
+        }
+        return (index - expected) / (maximum - expected);
+    }
+
+    /**
+     * Expected mutual information (in bits) of two random partitions with
+     * the same cluster sizes, under the hypergeometric model (Vinh et al.
+     * 2010). Clusters are grouped by size, so the cost depends on the number
+     * of distinct sizes rather than the number of clusters. Each sum over
+     * n_ij walks the hypergeometric probabilities by their ratio recurrence
+     * and stops once the remaining terms are negligible.
+     * @return Expected mutual information
+     */
+    double expectedMutualInformation() const {
+        if (sampleCount == 0) {
+            return 0;
+        }
+        double n = static_cast<double>(sampleCount);
+        double logN = log(n);
+        double emi = 0;
+
+        for (const auto& [a, rowMultiplicity] : groupSizes(rowSums)) {
+            for (const auto& [b, columnMultiplicity] : groupSizes(columnSums)) {
+                double da = static_cast<double>(a), db = static_cast<double>(b);
+                double low = max(1.0, da + db - n);
+                double high = min(da, db);
+                if (low > high) continue;
+
+                // log of the hypergeometric probability of n_ij = low
+                double logP = lgamma(da + 1) + lgamma(db + 1) + lgamma(n - da + 1) + lgamma(n - db + 1)
+                            - lgamma(n + 1) - lgamma(low + 1) - lgamma(da - low + 1) - lgamma(db - low + 1)
+                            - lgamma(n - da - db + low + 1);
+                double logAB = log(da) + log(db);
+                double mode = (da + 1) * (db + 1) / (n + 2);
+
+                double sum = 0;
+                for (double k = low; k <= high; k += 1) {
+                    double term = (k / n) * (logN + log(k) - logAB) * exp(logP);
+                    sum += term;
+                    if (k > mode && fabs(term) < 1e-17 * fabs(sum)) {
+                        break;
+                    }
+                    logP += log((da - k) * (db - k)) - log((k + 1) * (n - da - db + k + 1));
+                }
+                emi += static_cast<double>(rowMultiplicity) * static_cast<double>(columnMultiplicity) * sum;
+            }
+        }
+        return emi / log(2.0);
+    }
+
+    /**
+     * Adjusted mutual information with arithmetic mean normalization,
+     * (I - E[I]) / ((H1 + H2) / 2 - E[I])
+     * @return AMI, 1 for identical partitions and about 0 for random ones
+     */
+    double adjustedMutualInformation() const {
+        return adjustedMutualInformation(mutualInformation(), expectedMutualInformation());
+    }
+
+    /**
+     * Variation of information, H1 + H2 - 2 I, in bits
+     * @return VI, 0 for identical partitions
+     */
+    double variationOfInformation() const {
+        double h1 = rowEntropy();
+        double h2 = columnEntropy();
+        double mi = h1 + h2 - jointEntropy();
+        return max(0.0, h1 + h2 - 2 * mi);
+    }
+
+    /**
+     * Best-match F1: every cluster is matched with the cluster of the other
+     * partition that maximizes F1 = 2 n_ij / (a_i + b_j). The mean over rows
+     * and the mean over columns are averaged.
+     * @return F1 between 0 and 1
+     */
+    double bestMatchF1() const {
+        if (rowSums.empty() || columnSums.empty()) {
+            return 0;
+        }
+        vector<double> bestRow(rowSums.size(), 0.0);
+        vector<double> bestColumn(columnSums.size(), 0.0);
+        for (const Cell& cell : cells) {
+            double f1 = 2.0 * cell.count / static_cast<double>(rowSums[cell.row] + columnSums[cell.column]);
+            bestRow[cell.row] = max(bestRow[cell.row], f1);
+            bestColumn[cell.column] = max(bestColumn[cell.column], f1);
+        }
+        double rowMean = 0, columnMean = 0;
+        for (double f1 : bestRow) rowMean += f1;
+        for (double f1 : bestColumn) columnMean += f1;
+        return (rowMean / bestRow.size() + columnMean / bestColumn.size()) / 2;
+    }
+
+    /**
+     * All metrics at once; the entropies are computed a single time
+     * @return NMI, ARI, AMI, VI and F1
+     */
+    PartitionMetrics allMetrics() const {
+        double h1 = rowEntropy();
+        double h2 = columnEntropy();
+        double mi = h1 + h2 - jointEntropy();
+
+        PartitionMetrics metrics;
+        metrics.nmi = h1 + h2 == 0 ? 0 : 2 * mi / (h1 + h2);
+        metrics.ari = adjustedRandIndex();
+        metrics.ami = adjustedMutualInformation(mi, expectedMutualInformation(), h1, h2);
+        metrics.vi = max(0.0, h1 + h2 - 2 * mi);
+        metrics.f1 = bestMatchF1();
+        return metrics;
+    }
+
+private:
+    double adjustedMutualInformation(double mi, double emi) const {
+        return adjustedMutualInformation(mi, emi, rowEntropy(), columnEntropy());
+    }
+
+    static double adjustedMutualInformation(double mi, double emi, double h1, double h2) {
+        double denominator = (h1 + h2) / 2 - emi;
+        if (fabs(denominator) < 1e-12) {
+            // both partitions are all singletons or a single cluster
+            return 1.0;
+        }
+        return (mi - emi) / denominator;
+    }
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef COVEROVERLAP_H
+#define COVEROVERLAP_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>       // For uint32_t, uint64_t
+#include <stdexcept>     // For exceptions
+#include <algorithm>     // For sort, min
+#include <cmath>         // For log2
+using namespace std;
+
+
+/**
+ * Sparse intersection counts of two covers (possibly overlapping sets of
+ * clusters) over the same nodes, and the overlapping NMI variants of
+ * Lancichinetti, Fortunato and Kertesz (2009) and McDaid, Greene and Hurley
+ * (2011) derived from them.
+ *
+ * Clusters are lists of dense node indices in [0, numNodes). Only pairs of
+ * clusters that share at least one node are stored, found by walking the
+ * memberships of every node, so the cost grows with the memberships rather
+ * than with the product of the cluster counts. Disjoint pairs can still be
+ * the best match of a cluster (when both are large); they depend only on
+ * the two sizes and are handled per distinct size.
+ */
+class CoverOverlap {
+public:
+    struct Cell {
+        uint32_t row;
+        uint32_t column;
+        uint64_t count;
+    };
+
+private:
+    size_t nodeCount = 0;
+    vector<uint64_t> rowSizes;     // per cluster of the first cover
+    vector<uint64_t> columnSizes;  // per cluster of the second cover
+    vector<Cell> cells;            // non-zero intersections sorted by (row, column)
+
+    static double h(double p) {
+        return p > 0 ? -p * log2(p) : 0;
+    }
+
+    // Entropy in bits of membership in a cluster of the given size
+    double clusterEntropy(uint64_t size) const {
+        double p = static_cast<double>(size) / nodeCount;
+        return h(p) + h(1 - p);
+    }
+
+    /**
+     * Best conditional entropy H(X_i | Y) of every cluster of one cover given
+     * the other: the smallest H(X_i | Y_j) over the clusters Y_j that pass
+     * the LFK constraint h(p11) + h(p00) > h(p01) + h(p10), or H(X_i) if none
+     * does. Expects the cells sorted by row.
+     */
+    vector<double> conditionalEntropies(const vector<uint64_t>& sizes, const vector<uint64_t>& otherSizes,
+                                        const vector<Cell>& sortedCells) const {
+        double n = static_cast<double>(nodeCount);
+        vector<double> best(sizes.size());
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            best[i] = clusterEntropy(sizes[i]);
+        }
+
+        auto consider = [&](uint32_t row, uint64_t b, uint64_t common) {
+            uint64_t a = sizes[row];
+            double h11 = h(common / n);
+            double h10 = h((a - common) / n);
+            double h01 = h((b - common) / n);
+            double h00 = h((nodeCount - a - b + common) / n);
+            if (h11 + h00 > h01 + h10) {
+                best[row] = min(best[row], h11 + h10 + h01 + h00 - clusterEntropy(b));
+            }
+        };
+
+        // distinct sizes of the other cover, largest first, with multiplicities
+        vector<uint64_t> sortedOther(otherSizes);
+        sort(sortedOther.rbegin(), sortedOther.rend());
+        vector<pair<uint64_t, uint64_t>> otherGroups;
+        for (uint64_t size : sortedOther) {
+            if (!otherGroups.empty() && otherGroups.back().first == size) {
+                ++otherGroups.back().second;
+            } else {
+                otherGroups.emplace_back(size, 1);
+            }
+        }
+
+        vector<uint64_t> largeIntersected;
+        size_t cell = 0;
+        for (uint32_t row = 0; row < sizes.size(); ++row) {
+            uint64_t a = sizes[row];
+            largeIntersected.clear();
+            for (; cell < sortedCells.size() && sortedCells[cell].row == row; ++cell) {
+                uint64_t b = otherSizes[sortedCells[cell].column];
+                consider(row, b, sortedCells[cell].count);
+                if (2 * (a + b) > nodeCount) {
+                    largeIntersected.push_back(b);
+                }
+            }
+
+            // A disjoint pair covering at most half of the nodes never passes
+            // the constraint (h(1 - s) <= h(s) <= h(p01) + h(p10) for s <= 1/2),
+            // so only the sizes with 2 (a + b) > n need a disjoint cluster.
+            sort(largeIntersected.rbegin(), largeIntersected.rend());
+            size_t k = 0;
+            for (const auto& [b, multiplicity] : otherGroups) {
+                if (2 * (a + b) <= nodeCount) break;
+                uint64_t intersected = 0;
+                while (k < largeIntersected.size() && largeIntersected[k] > b) ++k;
+                while (k < largeIntersected.size() && largeIntersected[k] == b) {
+                    ++intersected;
+                    ++k;
+                }
+                if (multiplicity > intersected && a + b <= nodeCount) {
+                    consider(row, b, 0);
+                }
+            }
+        }
+        return best;
+    }
+
+    vector<Cell> transposedCells() const {
+        vector<Cell> transposed;
+        transposed.reserve(cells.size());
+        for (const Cell& c : cells) {
+            transposed.push_back({c.column, c.row, c.count});
+        }
+        sort(transposed.begin(), transposed.end(), [](const Cell& x, const Cell& y) {
+            return x.row != y.row ? x.row < y.row : x.column < y.column;
+        });
+        return transposed;
+    }
+
+public:
+    /**
+     * Counts the intersections of two covers
+     * @param numNodes Number of nodes both covers are drawn from
+     * @param cover1 Clusters of the first cover (rows), each a list of distinct node indices
+     * @param cover2 Clusters of the second cover (columns)
+     */
+    CoverOverlap(size_t numNodes, const vector<vector<uint32_t>>& cover1, const vector<vector<uint32_t>>& cover2)
+        : nodeCount(numNodes) {
+        rowSizes.reserve(cover1.size());
+        columnSizes.reserve(cover2.size());
+        for (const auto& cluster : cover1) rowSizes.push_back(cluster.size());
+        for (const auto& cluster : cover2) columnSizes.push_back(cluster.size());
+
+        // clusters of the second cover containing each node, in CSR form
+        vector<uint64_t> offsets(numNodes + 1, 0);
+        for (const auto& cluster : cover2) {
+            for (uint32_t node : cluster) {
+                if (node >= numNodes) {
+                    throw out_of_range("Node index outside of the cover universe");
+                }
+                ++offsets[node + 1];
+            }
+        }
+        for (size_t node = 0; node < numNodes; ++node) {
+            offsets[node + 1] += offsets[node];
+        }
+        vector<uint32_t> memberships(offsets[numNodes]);
+        vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t column = 0; column < cover2.size(); ++column) {
+            for (uint32_t node : cover2[column]) {
+                memberships[fill[node]++] = column;
+            }
+        }
+
+        vector<uint64_t> counts(cover2.size(), 0);
+        vector<uint32_t> touched;
+        for (uint32_t row = 0; row < cover1.size(); ++row) {
+            for (uint32_t node : cover1[row]) {
+                if (node >= numNodes) {
+                    throw out_of_range("Node index outside of the cover universe");
+                }
+                for (uint64_t m = offsets[node]; m < offsets[node + 1]; ++m) {
+                    if (counts[memberships[m]]++ == 0) {
+                        touched.push_back(memberships[m]);
+                    }
+                }
+            }
+            sort(touched.begin(), touched.end());
+            for (uint32_t column : touched) {
+                cells.push_back({row, column, counts[column]});
+                counts[column] = 0;
+            }
+            touched.clear();
+        }
+    }
+
+    size_t getNodeCount() const { return nodeCount; }
+
+    const vector<uint64_t>& getRowSizes() const { return rowSizes; }
+
+    const vector<uint64_t>& getColumnSizes() const { return columnSizes; }
+
+    const vector<Cell>& getCells() const { return cells; }
+
+    /**
+     * Overlapping NMI of Lancichinetti, Fortunato and Kertesz (2009):
+     * 1 - (H(X|Y)_norm + H(Y|X)_norm) / 2, where H(X|Y)_norm is the mean over
+     * the clusters of X of H(X_i | Y) / H(X_i)
+     * @return NMI between 0 and 1, 1 for identical covers
+     */
+    double lfkNMI() const {
+        if (rowSizes.empty() || columnSizes.empty()) {
+            return rowSizes.empty() && columnSizes.empty() ? 1.0 : 0.0;
+        }
+        auto normalizedConditional = [&](const vector<uint64_t>& sizes, const vector<double>& conditional) {
+            double sum = 0;
+            for (size_t i = 0; i < sizes.size(); ++i) {
+                double entropy = clusterEntropy(sizes[i]);
+                // a cluster of every node or of none carries no information
+                sum += entropy > 0 ? conditional[i] / entropy : 0;
+            }
+            return sum / sizes.size();
+        };
+        double rowsGivenColumns = normalizedConditional(rowSizes, conditionalEntropies(rowSizes, columnSizes, cells));
+        double columnsGivenRows = normalizedConditional(columnSizes, conditionalEntropies(columnSizes, rowSizes, transposedCells()));
+        return 1 - (rowsGivenColumns + columnsGivenRows) / 2;
+    }
+
+    /**
+     * Overlapping NMI of McDaid, Greene and Hurley (2011), normalized by the
+     * larger cover entropy: I(X:Y) / max(H(X), H(Y)) with
+     * I(X:Y) = (H(X) - H(X|Y) + H(Y) - H(Y|X)) / 2 and H(X) = sum of H(X_i)
+     * @return NMI between 0 and 1, 1 for identical covers
+     */
+    double mcdaidNMI() const {
+        double hRows = 0, hColumns = 0, rowsGivenColumns = 0, columnsGivenRows = 0;
+        for (uint64_t size : rowSizes) hRows += clusterEntropy(size);
+        for (uint64_t size : columnSizes) hColumns += clusterEntropy(size);
+        for (double entropy : conditionalEntropies(rowSizes, columnSizes, cells)) rowsGivenColumns += entropy;
+        for (double entropy : conditionalEntropies(columnSizes, rowSizes, transposedCells())) columnsGivenRows += entropy;
+
+        double maximum = max(hRows, hColumns);
+        if (maximum == 0) {
+            // no cover carries information, e.g. both are a single cluster of every node
+            return rowSizes.empty() == columnSizes.empty() ? 1.0 : 0.0;
+        }
+        double mutual = (hRows - rowsGivenColumns + hColumns - columnsGivenRows) / 2;
+        return max(0.0, min(1.0, mutual / maximum));
+    }
+};
+
+#endif
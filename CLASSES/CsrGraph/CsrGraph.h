@@ -0,0 +1,380 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <cstdint>       // For fixed width ids and offsets
+#include <cstring>       // For memcpy / memcmp
+#include <fstream>       // For file I/O
+#include <string>        // For string operations
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <algorithm>     // For lower_bound
+#include <type_traits>   // For is_trivially_copyable
+#include <sys/mman.h>    // For mmap
+#include <sys/stat.h>    // For fstat
+#include <fcntl.h>       // For open
+#include <unistd.h>      // For close
+using namespace std;
+
+
+// Read-only view over the neighbors of one vertex in a CsrGraph.
+// targets[i] is the dense id of the i-th neighbor and weights[i] its edge weight.
+struct CsrNeighborRange {
+    const uint32_t* targets = nullptr;
+    const double* weights = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint32_t target(size_t i) const { return targets[i]; }
+    double weight(size_t i) const { return weights[i]; }
+};
+
+
+// Header of the binary CSR file format (see CsrGraph::saveBinary).
+// The file is laid out as
+//    header | ids[N] | pad to 8 | offsets[N+1] | weightedDegrees[N] | weights[S] | targets[S]
+// with N = numVertices and S = numEntries (sum of degrees), all in native byte order.
+struct CsrFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t idSize;          // sizeof(T)
+    uint32_t byteOrderMark;   // CSR_BYTE_ORDER_MARK as written by the saving machine
+    uint32_t reserved;
+    uint64_t numVertices;
+    uint64_t numEdges;
+    uint64_t numEntries;
+    double totalWeight;
+    uint64_t padding;
+};
+
+static const char CSR_FILE_MAGIC[8] = {'U', 'R', 'P', 'C', 'S', 'R', '\0', '\0'};
+static const uint32_t CSR_FILE_VERSION = 1;
+static const uint32_t CSR_BYTE_ORDER_MARK = 0x01020304;
+
+
+// Immutable compressed sparse row (CSR) snapshot of a Graph<T>.
+// Vertices are compacted to dense ids 0..N-1 in ascending order of T, so the
+// id of a vertex can be found by binary search and the whole graph can be
+// scanned sequentially through three flat arrays:
+//    offsets[id] .. offsets[id+1]   -> slice of targets/weights for vertex id
+//    targets                         -> neighbor ids
+//    weights                         -> edge weights
+// Every undirected edge is stored once in each endpoint's slice (exactly like
+// Graph<T>::adjacencyList), and each slice is sorted by neighbor id.
+// Build one with Graph<T>::freeze(), or map a saved one with loadBinary().
+//
+// The arrays are views into shared storage (owned vectors or a memory mapped
+// file), so copies are cheap and share the same data.
+template <typename T>
+class CsrGraph {
+private:
+    // storage for snapshots built in memory
+    struct OwnedArrays {
+        vector<T> ids;
+        vector<uint64_t> offsets;
+        vector<uint32_t> targets;
+        vector<double> weights;
+        vector<double> weightedDegrees;
+    };
+
+    shared_ptr<const void> storage;            // keeps the arrays below alive
+    const T* ids = nullptr;                    // dense id -> vertex, sorted ascending
+    const uint64_t* offsets = nullptr;         // size N+1
+    const uint32_t* targets = nullptr;         // size = sum of degrees
+    const double* weights = nullptr;           // parallel to targets
+    const double* weightedDegrees = nullptr;   // dense id -> sum(all connected edges)
+    size_t numVertices = 0;
+    size_t edgeCount = 0;
+    double totalWeight = 0;
+
+    void attach(shared_ptr<OwnedArrays> arrays) {
+        ids = arrays->ids.data();
+        offsets = arrays->offsets.data();
+        targets = arrays->targets.data();
+        weights = arrays->weights.data();
+        weightedDegrees = arrays->weightedDegrees.data();
+        numVertices = arrays->ids.size();
+        storage = std::move(arrays);
+    }
+
+    static size_t alignTo8(size_t bytes) { return (bytes + 7) & ~static_cast<size_t>(7); }
+
+public:
+    CsrGraph() {
+        auto arrays = make_shared<OwnedArrays>();
+        arrays->offsets.assign(1, 0);
+        attach(std::move(arrays));
+    }
+
+    // Takes ownership of already built CSR arrays. idToVertex must be sorted
+    // and every slice of targets/weights must be sorted by target id.
+    CsrGraph(vector<T> idToVertex, vector<uint64_t> offsets, vector<uint32_t> targets,
+             vector<double> weights, double totalWeight, size_t edgeCount)
+        : edgeCount(edgeCount), totalWeight(totalWeight) {
+        if (offsets.size() != idToVertex.size() + 1 || targets.size() != weights.size() ||
+            offsets.back() != targets.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        }
+
+        auto arrays = make_shared<OwnedArrays>();
+        arrays->ids = std::move(idToVertex);
+        arrays->offsets = std::move(offsets);
+        arrays->targets = std::move(targets);
+        arrays->weights = std::move(weights);
+
+        arrays->weightedDegrees.assign(arrays->ids.size(), 0.0);
+        for (size_t id = 0; id < arrays->ids.size(); ++id) {
+            for (uint64_t e = arrays->offsets[id]; e < arrays->offsets[id + 1]; ++e) {
+                arrays->weightedDegrees[id] += arrays->weights[e];
+            }
+        }
+        attach(std::move(arrays));
+    }
+
+    // vertex operations
+
+    size_t getVertexCount() const { return numVertices; }
+
+    bool hasVertex(const T& vertex) const {
+        const T* it = lower_bound(ids, ids + numVertices, vertex);
+        return it != ids + numVertices && *it == vertex;
+    }
+
+    uint32_t getId(const T& vertex) const {
+        const T* it = lower_bound(ids, ids + numVertices, vertex);
+        if (it == ids + numVertices || !(*it == vertex)) {
+            throw std::logic_error("Vertex does not exist");
+        }
+        return static_cast<uint32_t>(it - ids);
+    }
+
+    const T& getVertex(uint32_t id) const {
+        if (id >= numVertices) {
+            throw std::out_of_range("Vertex id out of range");
+        }
+        return ids[id];
+    }
+
+    size_t getDegree(uint32_t id) const { return offsets[id + 1] - offsets[id]; }
+
+    double getWeightedDegree(uint32_t id) const { return weightedDegrees[id]; }
+
+    // edge operations
+
+    size_t getEdgeCount() const { return edgeCount; }
+
+    // number of (vertex, neighbor) entries, i.e. the length of the targets array
+    size_t getEntryCount() const { return offsets[numVertices]; }
+
+    double getTotalWeight() const { return totalWeight; }
+
+    CsrNeighborRange neighbors(uint32_t id) const {
+        CsrNeighborRange range;
+        range.targets = targets + offsets[id];
+        range.weights = weights + offsets[id];
+        range.count = offsets[id + 1] - offsets[id];
+        return range;
+    }
+
+    bool hasEdge(uint32_t from, uint32_t to) const {
+        return findEdge(from, to) != nullptr;
+    }
+
+    double getEdgeWeight(uint32_t from, uint32_t to) const {
+        const double* weight = findEdge(from, to);
+        if (!weight) {
+            throw std::logic_error("Edge does not exist");
+        }
+        return *weight;
+    }
+
+    // Modularity Q = sum_c [ L_c/m - (K_c/2m)^2 ] of the partition given by
+    // labels[id] (small non-negative ints, negative = no community), computed
+    // in one sequential scan over the CSR arrays. Matches
+    // Graph<T>::calculateModularity: self-loops count towards K_c only.
+    double calculateModularity(const vector<int>& labels) const {
+        if (labels.size() != numVertices) {
+            throw std::invalid_argument("Label vector size does not match vertex count");
+        }
+        double m = totalWeight;
+        if (m <= 0) {
+            return 0.0;
+        }
+
+        int maxLabel = -1;
+        for (int label : labels) {
+            maxLabel = max(maxLabel, label);
+        }
+        vector<double> L(maxLabel + 1, 0.0);
+        vector<double> K(maxLabel + 1, 0.0);
+
+        for (size_t id = 0; id < numVertices; ++id) {
+            int label = labels[id];
+            if (label < 0) continue;
+            K[label] += weightedDegrees[id];
+            // each edge once, from its lower endpoint
+            for (uint64_t e = offsets[id]; e < offsets[id + 1]; ++e) {
+                if (targets[e] > id && labels[targets[e]] == label) {
+                    L[label] += weights[e];
+                }
+            }
+        }
+
+        double modularity = 0.0;
+        for (int c = 0; c <= maxLabel; ++c) {
+            modularity += L[c] / m - (K[c] / (2.0 * m)) * (K[c] / (2.0 * m));
+        }
+        return modularity;
+    }
+
+    // raw arrays, for sequential scans over the whole graph
+
+    const T* getVertexData() const { return ids; }
+    const uint64_t* getOffsets() const { return offsets; }
+    const uint32_t* getTargets() const { return targets; }
+    const double* getWeights() const { return weights; }
+
+    // binary file format
+
+    // Write the snapshot in the versioned binary format described at CsrFileHeader.
+    // Only vertex types that can be copied byte-wise (integer ids) are supported.
+    void saveBinary(const string& filename) const {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Binary CSR files require a trivially copyable vertex type");
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+
+        CsrFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+        header.version = CSR_FILE_VERSION;
+        header.idSize = sizeof(T);
+        header.byteOrderMark = CSR_BYTE_ORDER_MARK;
+        header.numVertices = numVertices;
+        header.numEdges = edgeCount;
+        header.numEntries = getEntryCount();
+        header.totalWeight = totalWeight;
+
+        const char zeros[8] = {0};
+        size_t idBytes = numVertices * sizeof(T);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(ids), idBytes);
+        file.write(zeros, alignTo8(idBytes) - idBytes);
+        file.write(reinterpret_cast<const char*>(offsets), (numVertices + 1) * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(weightedDegrees), numVertices * sizeof(double));
+        file.write(reinterpret_cast<const char*>(weights), getEntryCount() * sizeof(double));
+        file.write(reinterpret_cast<const char*>(targets), getEntryCount() * sizeof(uint32_t));
+
+        if (!file) {
+            throw std::runtime_error("Error writing file: " + filename);
+        }
+    }
+
+    // Memory map a file written by saveBinary(). Nothing is parsed or copied:
+    // neighbor queries read straight from the mapping, which stays alive as
+    // long as any copy of the returned graph does. Before returning, the
+    // offsets and targets are validated in one pass, which reads every one
+    // of their pages: the load time grows with the edge count (a few ms per
+    // million edges on a warm page cache), and a cold file is read from disk.
+    static CsrGraph<T> loadBinary(const string& filename) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Binary CSR files require a trivially copyable vertex type");
+
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CsrFileHeader)) {
+            close(fd);
+            throw std::runtime_error("Not a binary CSR file: " + filename);
+        }
+        size_t fileSize = static_cast<size_t>(info.st_size);
+        void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map file: " + filename);
+        }
+        shared_ptr<const void> owner(mapping, [fileSize](const void* p) {
+            munmap(const_cast<void*>(p), fileSize);
+        });
+
+        const char* base = static_cast<const char*>(mapping);
+        CsrFileHeader header;
+        memcpy(&header, base, sizeof(header));
+        if (memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Not a binary CSR file: " + filename);
+        }
+        if (header.version != CSR_FILE_VERSION) {
+            throw std::runtime_error("Unsupported binary CSR version " + to_string(header.version));
+        }
+        if (header.byteOrderMark != CSR_BYTE_ORDER_MARK) {
+            throw std::runtime_error("Binary CSR file was written with a different byte order");
+        }
+        if (header.idSize != sizeof(T)) {
+            throw std::runtime_error("Binary CSR file has " + to_string(header.idSize) +
+                                     "-byte vertex ids, expected " + to_string(sizeof(T)));
+        }
+
+        // no section is larger than the file, which keeps the layout
+        // arithmetic below from wrapping for a bad header
+        size_t n = header.numVertices;
+        size_t s = header.numEntries;
+        if (n >= fileSize / max(sizeof(T), sizeof(uint64_t)) || s > fileSize / sizeof(double)) {
+            throw std::runtime_error("Truncated or corrupt binary CSR file: " + filename);
+        }
+        size_t idsAt = sizeof(CsrFileHeader);
+        size_t offsetsAt = idsAt + alignTo8(n * sizeof(T));
+        size_t degreesAt = offsetsAt + (n + 1) * sizeof(uint64_t);
+        size_t weightsAt = degreesAt + n * sizeof(double);
+        size_t targetsAt = weightsAt + s * sizeof(double);
+        if (targetsAt + s * sizeof(uint32_t) != fileSize) {
+            throw std::runtime_error("Truncated or corrupt binary CSR file: " + filename);
+        }
+
+        CsrGraph<T> graph;
+        graph.storage = std::move(owner);
+        graph.ids = reinterpret_cast<const T*>(base + idsAt);
+        graph.offsets = reinterpret_cast<const uint64_t*>(base + offsetsAt);
+        graph.weightedDegrees = reinterpret_cast<const double*>(base + degreesAt);
+        graph.weights = reinterpret_cast<const double*>(base + weightsAt);
+        graph.targets = reinterpret_cast<const uint32_t*>(base + targetsAt);
+        graph.numVertices = n;
+        graph.edgeCount = header.numEdges;
+        graph.totalWeight = header.totalWeight;
+
+        // one pass over the arrays, so no query can read outside the mapping:
+        // offsets run from 0 to s without decreasing, every target is a vertex
+        bool valid = graph.offsets[0] == 0 && graph.offsets[n] == s;
+        for (size_t id = 0; valid && id < n; ++id) {
+            valid = graph.offsets[id] <= graph.offsets[id + 1];
+        }
+        for (size_t e = 0; valid && e < s; ++e) {
+            valid = graph.targets[e] < n;
+        }
+        if (!valid) {
+            throw std::runtime_error("Truncated or corrupt binary CSR file: " + filename);
+        }
+        return graph;
+    }
+
+private:
+    // binary search in the (sorted) slice of from
+    const double* findEdge(uint32_t from, uint32_t to) const {
+        if (from >= numVertices) { return nullptr; }
+        const uint32_t* begin = targets + offsets[from];
+        const uint32_t* end = targets + offsets[from + 1];
+        const uint32_t* it = lower_bound(begin, end, to);
+        if (it == end || *it != to) { return nullptr; }
+        return weights + (it - targets);
+    }
+};
+
+#endif
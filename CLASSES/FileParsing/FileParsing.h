@@ -0,0 +1,278 @@
+#ifndef FILEPARSING_H
+#define FILEPARSING_H
+
+#include <iostream>
+#include <vector>
+#include <fstream>       // For file I/O
+#include <sstream>       // For the generic token fallback
+#include <string>        // For string operations
+#include <stdexcept>     // For exceptions
+#include <charconv>      // For from_chars
+#include <cstdlib>       // For strtod
+#include <cstring>       // For memchr / memmove
+#include <type_traits>   // For is_integral
+#include <thread>        // For parallel chunk parsing
+#include <mutex>
+#include <exception>     // For exception_ptr
+#include <algorithm>     // For max
+using namespace std;
+
+
+// Reads a text file in large blocks and hands out complete lines as
+// [begin, end) pointers into its internal buffer, so no per-line string is
+// allocated. The pointers stay valid until the next call to nextLine().
+// The buffer always keeps a '\0' after the buffered data, which makes it safe
+// to hand a token to C parsing routines.
+class ChunkedLineReader {
+private:
+    ifstream file;
+    vector<char> buffer;
+    size_t begin = 0;      // first unread byte
+    size_t end = 0;        // one past the last buffered byte
+    bool eof = false;
+    size_t lineNumber = 0;
+    size_t bufferOffset = 0;  // file offset of buffer[0]
+
+    // Move the unread tail to the front of the buffer and read another block
+    void refill() {
+        if (begin > 0) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            bufferOffset += begin;
+            begin = 0;
+        }
+        // a single line longer than the buffer: grow it
+        if (end + 1 >= buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        file.read(buffer.data() + end, buffer.size() - 1 - end);
+        end += static_cast<size_t>(file.gcount());
+        if (!file) {
+            eof = true;
+        }
+        buffer[end] = '\0';
+    }
+
+public:
+    explicit ChunkedLineReader(const string& filename, size_t chunkSize = 1 << 22)
+        : file(filename, ios::binary), buffer(chunkSize + 1) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file: " + filename);
+        }
+        buffer[0] = '\0';
+    }
+
+    // Returns false once the file is exhausted. A trailing '\r' is dropped.
+    bool nextLine(const char*& lineBegin, const char*& lineEnd) {
+        while (true) {
+            const char* start = buffer.data() + begin;
+            const char* newline = static_cast<const char*>(memchr(start, '\n', end - begin));
+            if (newline) {
+                lineBegin = start;
+                lineEnd = newline;
+                begin = static_cast<size_t>(newline - buffer.data()) + 1;
+                break;
+            }
+            if (eof) {
+                if (begin == end) {
+                    return false;
+                }
+                // last line without a trailing newline
+                lineBegin = start;
+                lineEnd = buffer.data() + end;
+                begin = end;
+                break;
+            }
+            refill();
+        }
+
+        if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') {
+            --lineEnd;
+        }
+        ++lineNumber;
+        return true;
+    }
+
+    // 1-based number of the last line returned by nextLine()
+    size_t getLineNumber() const { return lineNumber; }
+
+    // File offset of the first byte after the last line returned by nextLine()
+    size_t getOffset() const { return bufferOffset + begin; }
+};
+
+
+// Calls onLine(lineBegin, lineEnd) for every line of [begin, end), split the
+// same way as ChunkedLineReader::nextLine. Stops early when onLine returns false.
+template <typename OnLine>
+void forEachLine(const char* begin, const char* end, OnLine onLine) {
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        const char* lineEnd = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        if (lineEnd > begin && *(lineEnd - 1) == '\r') {
+            --lineEnd;
+        }
+        if (!onLine(begin, lineEnd)) {
+            return;
+        }
+        begin = next;
+    }
+}
+
+// Splits [offset, end of file) into at most numChunks ranges that each start
+// at the beginning of a line. Returns the boundaries, first offset to end of
+// file; a line is never cut, so a chunk may be empty or larger than the rest.
+inline vector<size_t> lineAlignedChunks(const string& filename, size_t offset, size_t numChunks) {
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    offset = min(offset, fileSize);
+    numChunks = max<size_t>(numChunks, 1);
+
+    vector<size_t> bounds(1, offset);
+    char block[4096];
+    for (size_t i = 1; i < numChunks; ++i) {
+        // the next chunk starts after the first newline at or past the cut
+        size_t cut = max(bounds.back(), offset + (fileSize - offset) / numChunks * i);
+        if (cut == offset || cut >= fileSize) {
+            bounds.push_back(min(cut, fileSize));
+            continue;
+        }
+        file.clear();
+        file.seekg(static_cast<streamoff>(cut - 1));
+        size_t position = cut - 1;
+        size_t start = fileSize;
+        while (start == fileSize) {
+            file.read(block, sizeof(block));
+            size_t count = static_cast<size_t>(file.gcount());
+            if (count == 0) {
+                break;
+            }
+            const char* newline = static_cast<const char*>(memchr(block, '\n', count));
+            if (newline) {
+                start = position + static_cast<size_t>(newline - block) + 1;
+            }
+            position += count;
+        }
+        bounds.push_back(start);
+    }
+    bounds.push_back(fileSize);
+    return bounds;
+}
+
+// Parses [offset, end of file) on numThreads threads (0 for every hardware
+// thread). The range is cut into newline-aligned chunks, one per thread,
+// and every chunk is read into its own buffer (with a '\0' after it) and
+// handed to parseChunk(chunkIndex, begin, end). Results are collected per
+// chunk by the caller and merged in chunk order, which is file order. The
+// first exception thrown by parseChunk is rethrown once all threads finish.
+template <typename ParseChunk>
+void parseChunksInParallel(const string& filename, size_t offset, unsigned numThreads, ParseChunk parseChunk) {
+    if (numThreads == 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    vector<size_t> bounds = lineAlignedChunks(filename, offset, numThreads);
+    size_t numChunks = bounds.size() - 1;
+
+    exception_ptr failure;
+    mutex failureLock;
+    auto work = [&](size_t chunk) {
+        try {
+            vector<char> buffer(bounds[chunk + 1] - bounds[chunk] + 1);
+            ifstream file(filename, ios::binary);
+            file.seekg(static_cast<streamoff>(bounds[chunk]));
+            file.read(buffer.data(), static_cast<streamsize>(buffer.size() - 1));
+            if (static_cast<size_t>(file.gcount()) != buffer.size() - 1) {
+                throw std::runtime_error("Could not read file: " + filename);
+            }
+            buffer.back() = '\0';
+            parseChunk(chunk, static_cast<const char*>(buffer.data()), buffer.data() + buffer.size() - 1);
+        } catch (...) {
+            lock_guard<mutex> guard(failureLock);
+            if (!failure) failure = current_exception();
+        }
+    };
+    if (numChunks <= 1) {
+        work(0);
+    } else {
+        vector<thread> workers;
+        for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+            workers.emplace_back(work, chunk);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    if (failure) {
+        rethrow_exception(failure);
+    }
+}
+
+
+// Token parsing on [p, end) ranges. Each parseToken skips leading blanks,
+// parses one whitespace separated value and advances p past it.
+
+inline void skipBlanks(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        ++p;
+    }
+}
+
+inline const char* tokenEnd(const char* p, const char* end) {
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+template <typename T>
+bool parseToken(const char*& p, const char* end, T& out) {
+    skipBlanks(p, end);
+    if (p == end) {
+        return false;
+    }
+    const char* stop = tokenEnd(p, end);
+
+    if constexpr (std::is_integral_v<T>) {
+        auto result = std::from_chars(p, stop, out);
+        if (result.ec != std::errc() || result.ptr != stop) {
+            return false;
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+#if defined(__cpp_lib_to_chars)
+        auto result = std::from_chars(p, stop, out);
+        if (result.ec != std::errc() || result.ptr != stop) {
+            return false;
+        }
+#else
+        // strtod stops at the blank (or the '\0' sentinel) after the token
+        char* parsedEnd = nullptr;
+        out = static_cast<T>(strtod(p, &parsedEnd));
+        if (parsedEnd != stop) {
+            return false;
+        }
+#endif
+    } else if constexpr (std::is_same_v<T, string>) {
+        out.assign(p, stop);
+    } else {
+        istringstream iss(string(p, stop));
+        if (!(iss >> out)) {
+            return false;
+        }
+    }
+
+    p = stop;
+    return true;
+}
+
+// Human readable form of a value for error messages
+template <typename T>
+string describeValue(const T& value) {
+    ostringstream oss;
+    oss << value;
+    return oss.str();
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef FREQFRACCOMMUNITIES_H
+#define FREQFRACCOMMUNITIES_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <memory>        // For unique_ptr
+#include <fstream>       // For file output
+#include <stdexcept>     // For exceptions
+#include "FreqFracHelper.h"
+using namespace std;
+
+
+/**
+ * Frequency- and fraction-based consensus communities of the groups
+ * generated for one network. The generated files are
+ * <pathToGeneratedGroupsFiles>/<nameOfFiles><i>.txt for i = 1 ... numOfFiles,
+ * each of "node community" lines; only the nodes of the original communities
+ * are kept. See FreqFracHelper for the scores.
+ */
+template <typename T>
+class FreqFracCommunities {
+private:
+    vector<T> originalNetworkNodes;
+    typename FreqFracHelper<T>::GroupFrequencies networksGroupsDict;
+    unique_ptr<FreqFracHelper<T>> helper;
+
+public:
+    /**
+     * Reads the original nodes and counts the groups of every generated file
+     * @param nodesOriginalCommunitiesFile Original communities, "node community" lines
+     * @param pathToGeneratedGroupsFiles Directory of the generated files
+     * @param numOfFiles Number of generated files
+     * @param nameOfFiles Common prefix of the generated file names
+     * @param numThreads Threads reading the generated files, 0 for every hardware thread
+     */
+    FreqFracCommunities(const string& nodesOriginalCommunitiesFile, const string& pathToGeneratedGroupsFiles,
+                        int numOfFiles, const string& nameOfFiles, unsigned numThreads = 0)
+        : helper(make_unique<FreqFracHelper<T>>(numThreads)) {
+        if (numOfFiles <= 0) {
+            throw invalid_argument("Number of generated files must be positive");
+        }
+        originalNetworkNodes = helper->readOriginalCommunityNodes(nodesOriginalCommunitiesFile);
+        vector<string> files;
+        files.reserve(numOfFiles);
+        for (int i = 1; i <= numOfFiles; ++i) {
+            files.push_back(pathToGeneratedGroupsFiles + "/" + nameOfFiles + to_string(i) + ".txt");
+        }
+        networksGroupsDict = helper->countNetworkGroups(files, originalNetworkNodes);
+    }
+
+    const vector<T>& getOriginalNetworkNodes() const { return originalNetworkNodes; }
+
+    const typename FreqFracHelper<T>::GroupFrequencies& getNetworksGroupsDict() const { return networksGroupsDict; }
+
+    /**
+     * Writes the frequency- and fraction-based communities and their scores
+     * to <outputPrefix>_freq.txt, <outputPrefix>_freq_score.txt,
+     * <outputPrefix>_frac.txt and <outputPrefix>_frac_score.txt
+     * @param outputPrefix Prefix of the output files
+     */
+    void processCommunities(const string& outputPrefix) {
+        auto frequencyBased = generateFrequencyBasedCommunities();
+        writeCommunities(frequencyBased.first, outputPrefix + "_freq.txt");
+        writeScore(frequencyBased.second, outputPrefix + "_freq_score.txt");
+        auto fractionBased = generateFractionBasedCommunities();
+        writeCommunities(fractionBased.first, outputPrefix + "_frac.txt");
+        writeScore(fractionBased.second, outputPrefix + "_frac_score.txt");
+    }
+
+    /**
+     * @return Pair of (consensus communities by group frequency, mean node penalty)
+     */
+    pair<vector<Community<T>>, double> generateFrequencyBasedCommunities() const {
+        return helper->freqFracBasedPredictions(networksGroupsDict, originalNetworkNodes, "freq");
+    }
+
+    /**
+     * @return Pair of (consensus communities by node fraction, mean node penalty)
+     */
+    pair<vector<Community<T>>, double> generateFractionBasedCommunities() const {
+        return helper->freqFracBasedPredictions(networksGroupsDict, originalNetworkNodes, "frac");
+    }
+
+    /**
+     * Writes "node community" lines, communities numbered from 0
+     * @param communities Communities to write
+     * @param filename Output file
+     */
+    void writeCommunities(const vector<Community<T>>& communities, const string& filename) const {
+        ofstream file(filename);
+        if (!file.is_open()) {
+            throw runtime_error("Could not open file for writing: " + filename);
+        }
+        for (size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for (const auto& node : communities[communityId].getNodes()) {
+                file << node << " " << communityId << "\n";
+            }
+        }
+    }
+
+    /**
+     * @param score Score to write
+     * @param filename Output file
+     */
+    void writeScore(double score, const string& filename) const {
+        ofstream file(filename);
+        if (!file.is_open()) {
+            throw runtime_error("Could not open file for writing: " + filename);
+        }
+        file << score << "\n";
+    }
+};
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef FREQFRACHELPER_H
+#define FREQFRACHELPER_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>       // For uint32_t
+#include <stdexcept>     // For exceptions
+#include <algorithm>     // For sort, unique
+#include <unordered_map>
+#include <thread>        // For parallel group counting
+#include <atomic>        // For the file counter
+#include <exception>     // For exception_ptr
+#include <mutex>         // For the failure lock
+#include "../Community/Community.h"
+#include "../FileParsing/FileParsing.h"
+using namespace std;
+
+
+/**
+ * Consensus communities over many generated partitions of the same nodes.
+ *
+ * Every generated file holds "node community" lines. The groups of all files
+ * are counted by their member sets: each distinct group gets its frequency,
+ * the fraction of the files it appears in. Groups are hashed with an
+ * order-independent fingerprint of their members (see fingerprintNodes), so
+ * counting needs no ordered set comparisons, and the files are read and
+ * counted by a pool of threads with one table per thread.
+ *
+ * The consensus picks the disjoint groups with the best score greedily:
+ * "freq" scores a group by its frequency, "frac" by the fraction of all node
+ * placements it accounts for (frequency * size / number of nodes), which
+ * favors large stable groups over small ones.
+ */
+template <typename T>
+class FreqFracHelper {
+public:
+    // Frequency of every distinct group, between 0 and 1
+    using GroupFrequencies = unordered_map<Community<T>, double, CommunityHash<T>>;
+
+private:
+    unsigned numThreads = 1;
+
+    // A group as sorted indices into the sorted nodes
+    using DenseGroup = vector<uint32_t>;
+
+    struct DenseGroupHash {
+        size_t operator()(const DenseGroup& group) const {
+            return static_cast<size_t>(fingerprintNodes(group.begin(), group.end()));
+        }
+    };
+
+    using DenseCounts = unordered_map<DenseGroup, uint32_t, DenseGroupHash>;
+
+    struct NodeIndex {
+        vector<T> nodes;                   // sorted, distinct
+        unordered_map<T, uint32_t> index;  // node -> position in nodes
+    };
+
+    static NodeIndex indexNodes(const vector<T>& nodes) {
+        NodeIndex result;
+        result.nodes = nodes;
+        sort(result.nodes.begin(), result.nodes.end());
+        result.nodes.erase(unique(result.nodes.begin(), result.nodes.end()), result.nodes.end());
+        result.index.reserve(result.nodes.size());
+        for (size_t i = 0; i < result.nodes.size(); ++i) {
+            result.index.emplace(result.nodes[i], static_cast<uint32_t>(i));
+        }
+        return result;
+    }
+
+    // Groups of one file in order of first appearance, nodes outside the index skipped
+    static vector<DenseGroup> readDenseGroups(const string& filename, const NodeIndex& nodeIndex) {
+        ChunkedLineReader reader(filename);
+        unordered_map<int, size_t> groupOf;
+        vector<DenseGroup> groups;
+        const char* lineBegin;
+        const char* lineEnd;
+        T node;
+        int communityId;
+
+        while (reader.nextLine(lineBegin, lineEnd)) {
+            const char* p = lineBegin;
+            if (!parseToken(p, lineEnd, node) || !parseToken(p, lineEnd, communityId)) {
+                continue;
+            }
+            auto found = nodeIndex.index.find(node);
+            if (found == nodeIndex.index.end()) {
+                continue;
+            }
+            auto slot = groupOf.try_emplace(communityId, groups.size());
+            if (slot.second) {
+                groups.emplace_back();
+            }
+            groups[slot.first->second].push_back(found->second);
+        }
+        for (DenseGroup& group : groups) {
+            sort(group.begin(), group.end());
+            group.erase(unique(group.begin(), group.end()), group.end());
+        }
+        return groups;
+    }
+
+    static Community<T> toCommunity(const DenseGroup& group, const vector<T>& nodes) {
+        vector<T> members;
+        members.reserve(group.size());
+        for (uint32_t i : group) {
+            members.push_back(nodes[i]);
+        }
+        // sorted indices give sorted nodes, so the insert is linear
+        Community<T> community;
+        community.addNodes(members.begin(), members.end());
+        return community;
+    }
+
+    static bool isFraction(const string& freqFrac) {
+        if (freqFrac == "freq") return false;
+        if (freqFrac == "frac") return true;
+        throw invalid_argument("Consensus score must be \"freq\" or \"frac\", got \"" + freqFrac + "\"");
+    }
+
+    static double frequencyOf(const GroupFrequencies& networksGroupsDict, const Community<T>& group) {
+        auto found = networksGroupsDict.find(group);
+        return found == networksGroupsDict.end() ? 0.0 : found->second;
+    }
+
+public:
+    FreqFracHelper() = default;
+
+    explicit FreqFracHelper(unsigned numThreads) { setNumThreads(numThreads); }
+
+    // 0 uses every hardware thread
+    void setNumThreads(unsigned threads) {
+        numThreads = threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
+    }
+
+    unsigned getNumThreads() const { return numThreads; }
+
+    /**
+     * Reads the nodes of the original communities
+     * @param nodesOriginalCommunities File of "node community" lines
+     * @return The distinct nodes, sorted
+     */
+    vector<T> readOriginalCommunityNodes(const string& nodesOriginalCommunities) const {
+        ChunkedLineReader reader(nodesOriginalCommunities);
+        vector<T> nodes;
+        const char* lineBegin;
+        const char* lineEnd;
+        T node;
+        while (reader.nextLine(lineBegin, lineEnd)) {
+            const char* p = lineBegin;
+            if (parseToken(p, lineEnd, node)) {
+                nodes.push_back(node);
+            }
+        }
+        sort(nodes.begin(), nodes.end());
+        nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+        return nodes;
+    }
+
+    /**
+     * Reads the groups of one generated file
+     * @param networkGroupsFile File of "node community" lines
+     * @param listOfNodes Nodes to keep; other nodes in the file are skipped
+     * @return One community per community id, in order of first appearance
+     */
+    vector<Community<T>> readNetworkGroups(const string& networkGroupsFile, const vector<T>& listOfNodes) const {
+        NodeIndex nodeIndex = indexNodes(listOfNodes);
+        vector<Community<T>> communities;
+        for (const DenseGroup& group : readDenseGroups(networkGroupsFile, nodeIndex)) {
+            communities.push_back(toCommunity(group, nodeIndex.nodes));
+        }
+        return communities;
+    }
+
+    /**
+     * Counts the distinct groups over all generated files. The files are
+     * split among the threads, each counting into its own hash table, and
+     * the tables are merged at the end.
+     * @param networkGroupsFiles Generated files of "node community" lines
+     * @param listOfNodes Nodes to keep; other nodes in the files are skipped
+     * @return Fraction of the files containing each distinct group
+     */
+    GroupFrequencies countNetworkGroups(const vector<string>& networkGroupsFiles, const vector<T>& listOfNodes) const {
+        NodeIndex nodeIndex = indexNodes(listOfNodes);
+        size_t fileCount = networkGroupsFiles.size();
+        unsigned threads = static_cast<unsigned>(min<size_t>(numThreads, max<size_t>(fileCount, 1)));
+        vector<DenseCounts> counts(threads);
+
+        atomic<size_t> next(0);
+        exception_ptr failure;
+        mutex failureLock;
+        auto work = [&](unsigned t) {
+            for (size_t i = next++; i < fileCount; i = next++) {
+                try {
+                    for (DenseGroup& group : readDenseGroups(networkGroupsFiles[i], nodeIndex)) {
+                        if (!group.empty()) {
+                            ++counts[t].try_emplace(move(group), 0).first->second;
+                        }
+                    }
+                } catch (...) {
+                    lock_guard<mutex> guard(failureLock);
+                    if (!failure) failure = current_exception();
+                }
+            }
+        };
+        if (threads <= 1) {
+            work(0);
+        } else {
+            vector<thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back(work, t);
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        if (failure) {
+            rethrow_exception(failure);
+        }
+
+        // move the table entries over instead of copying the groups
+        for (unsigned t = 1; t < threads; ++t) {
+            while (!counts[t].empty()) {
+                auto entry = counts[t].extract(counts[t].begin());
+                auto found = counts[0].find(entry.key());
+                if (found != counts[0].end()) {
+                    found->second += entry.mapped();
+                } else {
+                    counts[0].insert(move(entry));
+                }
+            }
+        }
+
+        GroupFrequencies networksGroupsDict;
+        networksGroupsDict.reserve(counts[0].size());
+        for (const auto& [group, count] : counts[0]) {
+            networksGroupsDict.emplace(toCommunity(group, nodeIndex.nodes), static_cast<double>(count) / fileCount);
+        }
+        return networksGroupsDict;
+    }
+
+    /**
+     * Penalty of every node under a predicted structure: one minus the
+     * frequency of the predicted group holding it (0 for a group that was
+     * never generated), and 1 for nodes outside every predicted group
+     * @param predictedCommunityStructure Predicted disjoint communities
+     * @param networksGroupsDict Group frequencies from countNetworkGroups
+     * @param nodes Nodes to score
+     * @return Penalty per node, aligned with nodes
+     */
+    vector<double> computeStructurePenalty(const vector<Community<T>>& predictedCommunityStructure,
+                                           const GroupFrequencies& networksGroupsDict,
+                                           const vector<T>& nodes) const {
+        unordered_map<T, double> frequencyOfNode;
+        for (const auto& community : predictedCommunityStructure) {
+            double frequency = frequencyOf(networksGroupsDict, community);
+            for (const auto& node : community.getNodes()) {
+                frequencyOfNode[node] = frequency;
+            }
+        }
+        vector<double> penalties;
+        penalties.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            auto found = frequencyOfNode.find(node);
+            penalties.push_back(found == frequencyOfNode.end() ? 1.0 : 1.0 - found->second);
+        }
+        return penalties;
+    }
+
+    /**
+     * Smallest penalty any group can give each node: one minus the highest
+     * frequency of a generated group holding it
+     * @param networksGroupsDict Group frequencies from countNetworkGroups
+     * @param nodes Nodes to score
+     * @return Penalty per node, aligned with nodes
+     */
+    vector<double> findPenaltyForEachNode(const GroupFrequencies& networksGroupsDict, const vector<T>& nodes) const {
+        unordered_map<T, double> bestFrequency;
+        for (const auto& [group, frequency] : networksGroupsDict) {
+            for (const auto& node : group.getNodes()) {
+                auto slot = bestFrequency.try_emplace(node, frequency);
+                slot.first->second = max(slot.first->second, frequency);
+            }
+        }
+        vector<double> penalties;
+        penalties.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            auto found = bestFrequency.find(node);
+            penalties.push_back(found == bestFrequency.end() ? 1.0 : 1.0 - found->second);
+        }
+        return penalties;
+    }
+
+    /**
+     * Consensus communities: the generated groups in order of decreasing
+     * score are kept while they do not share a node with a kept group, and
+     * the nodes left over become singletons
+     * @param networksGroupsDict Group frequencies from countNetworkGroups
+     * @param nodes Nodes to cover
+     * @param freqFrac "freq" to score groups by frequency, "frac" by frequency * size / number of nodes
+     * @return Pair of (communities, mean penalty of the nodes)
+     */
+    pair<vector<Community<T>>, double> freqFracBasedPredictions(const GroupFrequencies& networksGroupsDict,
+                                                               const vector<T>& nodes,
+                                                               const string& freqFrac) const {
+        bool fraction = isFraction(freqFrac);
+        NodeIndex nodeIndex = indexNodes(nodes);
+        double nodeCount = static_cast<double>(max<size_t>(nodeIndex.nodes.size(), 1));
+
+        struct Ranked {
+            double score;
+            size_t size;
+            uint64_t fingerprint;
+            const Community<T>* group;
+        };
+        vector<Ranked> ranked;
+        ranked.reserve(networksGroupsDict.size());
+        for (const auto& [group, frequency] : networksGroupsDict) {
+            double score = fraction ? frequency * group.size() / nodeCount : frequency;
+            ranked.push_back({score, group.size(), group.fingerprint(), &group});
+        }
+        // ties go to the larger group, then by fingerprint and members, so
+        // the result does not depend on the hash table order
+        sort(ranked.begin(), ranked.end(), [](const Ranked& x, const Ranked& y) {
+            if (x.score != y.score) return x.score > y.score;
+            if (x.size != y.size) return x.size > y.size;
+            if (x.fingerprint != y.fingerprint) return x.fingerprint < y.fingerprint;
+            return *x.group < *y.group;
+        });
+
+        vector<char> assigned(nodeIndex.nodes.size(), 0);
+        vector<Community<T>> communities;
+        for (const Ranked& candidate : ranked) {
+            const Community<T>* group = candidate.group;
+            bool free = true;
+            for (const auto& node : group->getNodes()) {
+                auto found = nodeIndex.index.find(node);
+                if (found == nodeIndex.index.end() || assigned[found->second]) {
+                    free = false;
+                    break;
+                }
+            }
+            if (!free) continue;
+            for (const auto& node : group->getNodes()) {
+                assigned[nodeIndex.index.find(node)->second] = 1;
+            }
+            communities.push_back(*group);
+        }
+        for (size_t i = 0; i < nodeIndex.nodes.size(); ++i) {
+            if (!assigned[i]) {
+                communities.emplace_back();
+                communities.back().addNode(nodeIndex.nodes[i]);
+            }
+        }
+
+        double total = 0;
+        for (double penalty : computeStructurePenalty(communities, networksGroupsDict, nodeIndex.nodes)) {
+            total += penalty;
+        }
+        return {communities, nodeIndex.nodes.empty() ? 0.0 : total / nodeIndex.nodes.size()};
+    }
+};
+
+#endif
@@ -45,6 +45,90 @@ Graph<T>::Graph(const std::string& filename) {
 
 }
 
+// Reads one value the way "iss >> value" does in the getline constructor:
+// integers take the longest numeric prefix, so a weight of "1.0" reads as 1
+template <typename V>
+bool parseStreamValue(const char*& p, const char* end, V& out) {
+    if constexpr (std::is_integral_v<V>) {
+        skipBlanks(p, end);
+        if (p < end && *p == '+' && p + 1 < end && *(p + 1) != '-') {
+            ++p;
+        }
+        auto result = std::from_chars(p, end, out);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+        return true;
+    } else {
+        return parseToken(p, end, out);
+    }
+}
+
+template <typename T>
+Graph<T>::Graph(const std::string& filename, unsigned numThreads) {
+    if(!std::ifstream(filename).is_open()) {
+        throw runtime_error("Could not open file" + filename);
+    }
+
+    // Per chunk: the edges in file order, and the text of each invalid line
+    // with the number of edges read before it
+    struct ParsedEdge {
+        T from, to;
+        int weight;
+    };
+    struct ParsedChunk {
+        std::vector<ParsedEdge> edges;
+        std::vector<std::pair<size_t, std::string>> invalidLines;
+    };
+
+    // Parse the chunks on their own threads, each into its own buffer
+    if (numThreads == 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    std::vector<ParsedChunk> chunks(numThreads);
+    parseChunksInParallel(filename, 0, numThreads,
+        [&](size_t chunk, const char* begin, const char* end) {
+            ParsedChunk& parsed = chunks[chunk];
+            forEachLine(begin, end, [&](const char* lineBegin, const char* lineEnd) {
+                const char* p = lineBegin;
+                ParsedEdge edge;
+                if (parseStreamValue(p, lineEnd, edge.from) && parseStreamValue(p, lineEnd, edge.to) &&
+                    parseStreamValue(p, lineEnd, edge.weight)) {
+                    parsed.edges.push_back(std::move(edge));
+                } else {
+                    parsed.invalidLines.emplace_back(parsed.edges.size(), std::string(lineBegin, lineEnd));
+                }
+                return true;
+            });
+        });
+
+    // Merge in file order, exactly like the single threaded constructor
+    for (const ParsedChunk& parsed : chunks) {
+        auto invalid = parsed.invalidLines.begin();
+        for (size_t i = 0; i <= parsed.edges.size(); ++i) {
+            for (; invalid != parsed.invalidLines.end() && invalid->first == i; ++invalid) {
+                cout << "INVALID LINE FORMAT -> " << invalid->second;
+            }
+            if (i == parsed.edges.size()) {
+                break;
+            }
+            const ParsedEdge& edge = parsed.edges[i];
+            if(!hasVertex(edge.from)) {
+                addVertex(edge.from);
+            }
+
+            if(!hasVertex(edge.to)) {
+                addVertex(edge.to);
+            }
+
+            if(!hasEdge(edge.from,edge.to) || !hasEdge(edge.to,edge.from)) {
+                addEdge(edge.from,edge.to,edge.weight);
+            }
+        }
+    }
+}
+
 template <typename T>
 void Graph<T>::addVertex(const T &vertex)
 {
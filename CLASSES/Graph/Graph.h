@@ -6,6 +6,7 @@
 #include <utility> 
 #include <cassert>
 #include <unordered_map>
+#include "../FileParsing/FileParsing.h"
 
 using namespace std;
 
@@ -19,6 +20,7 @@ private:
 public:
     Graph() = default;
     Graph(const std::string& filename);
+    Graph(const std::string& filename, unsigned numThreads); // parses newline-aligned chunks on numThreads threads (0 = all cores)
 
     // Core vertex operations
     void addVertex(const T& vertex); // adds a vertex to the adjacency list
@@ -0,0 +1,281 @@
+#ifndef FLATEDGEMAP_H
+#define FLATEDGEMAP_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>       // For uint8_t
+#include <cstddef>       // For ptrdiff_t
+#include <iterator>      // For forward_iterator_tag
+#include <stdexcept>     // For exceptions
+#include <type_traits>   // For conditional_t
+using namespace std;
+
+
+/**
+ * Open-addressing hash map used as the edge index of Graph<T> (edgeLookup).
+ *
+ * Entries live in one flat array of (key, value) pairs next to a byte array
+ * of slot states, with linear probing over a power of two capacity that is
+ * kept at most 3/4 full. A lookup hashes once and then scans adjacent slots,
+ * instead of following a bucket pointer to a separately allocated node as
+ * std::unordered_map does. The probe sequences are only short if the hash
+ * spreads its values over the low bits, so pair it with a mixing hash such
+ * as PairHash.
+ *
+ * Erasing leaves a tombstone instead of moving entries, so iterators and
+ * references stay valid across erase, and across inserts as long as the
+ * size stays within the last reserve(). Tombstones are dropped on rehash.
+ * Iteration runs in slot order. Offers the subset of the unordered_map
+ * interface Graph<T> uses; keys must not be modified through an iterator.
+ */
+template <typename K, typename V, typename Hash>
+class FlatEdgeMap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = pair<K, V>;
+
+private:
+    enum SlotState : uint8_t { EMPTY = 0, FULL = 1, ERASED = 2 };
+
+    vector<uint8_t> states;
+    vector<value_type> slots;
+    size_t count = 0;     // FULL slots
+    size_t erased = 0;    // ERASED slots
+    Hash hasher;
+
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    // Largest number of used (full or erased) slots before a rehash
+    static size_t maxUsed(size_t capacity) { return capacity - capacity / 4; }
+
+    size_t home(const K& key) const {
+        return hasher(key) & (slots.size() - 1);
+    }
+
+    // Slot holding key, or slots.size() if it is absent
+    size_t findSlot(const K& key) const {
+        if (count == 0) {
+            return slots.size();
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t slot = home(key); states[slot] != EMPTY; slot = (slot + 1) & mask) {
+            if (states[slot] == FULL && slots[slot].first == key) {
+                return slot;
+            }
+        }
+        return slots.size();
+    }
+
+    // First reusable slot on the probe sequence of a key that is absent
+    size_t insertSlot(const K& key) const {
+        size_t mask = slots.size() - 1;
+        size_t slot = home(key);
+        while (states[slot] == FULL) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    // Moves every entry into a table of newCapacity slots without tombstones
+    void rehash(size_t newCapacity) {
+        vector<uint8_t> oldStates = std::move(states);
+        vector<value_type> oldSlots = std::move(slots);
+        states.assign(newCapacity, EMPTY);
+        slots.assign(newCapacity, value_type());
+        erased = 0;
+        for (size_t slot = 0; slot < oldSlots.size(); ++slot) {
+            if (oldStates[slot] == FULL) {
+                size_t target = insertSlot(oldSlots[slot].first);
+                states[target] = FULL;
+                slots[target] = std::move(oldSlots[slot]);
+            }
+        }
+    }
+
+    // Smallest capacity that holds size entries
+    static size_t capacityFor(size_t size) {
+        size_t capacity = MIN_CAPACITY;
+        while (maxUsed(capacity) < size) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+public:
+    template <bool Const>
+    class Iterator {
+    private:
+        using Map = conditional_t<Const, const FlatEdgeMap, FlatEdgeMap>;
+        Map* map = nullptr;
+        size_t slot = 0;
+
+        friend class FlatEdgeMap;
+
+        // Advances to the next full slot, or to the end
+        void skipFree() {
+            while (slot < map->slots.size() && map->states[slot] != FULL) {
+                ++slot;
+            }
+        }
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = FlatEdgeMap::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = conditional_t<Const, const value_type&, value_type&>;
+        using pointer = conditional_t<Const, const value_type*, value_type*>;
+
+        Iterator() = default;
+        Iterator(Map* map, size_t slot) : map(map), slot(slot) {}
+
+        operator Iterator<true>() const { return Iterator<true>(map, slot); }
+
+        reference operator*() const { return map->slots[slot]; }
+        pointer operator->() const { return &map->slots[slot]; }
+
+        Iterator& operator++() {
+            ++slot;
+            skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const { return slot == other.slot && map == other.map; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatEdgeMap() = default;
+
+    size_t size() const { return count; }
+
+    bool empty() const { return count == 0; }
+
+    // Number of slots, full or not
+    size_t capacity() const { return slots.size(); }
+
+    void clear() {
+        states.clear();
+        slots.clear();
+        count = 0;
+        erased = 0;
+    }
+
+    /**
+     * Makes room for size entries: inserting until size() reaches it moves
+     * no entry and keeps every iterator valid.
+     * @param size Number of entries to make room for
+     */
+    void reserve(size_t size) {
+        if (slots.empty() || size + erased > maxUsed(slots.size())) {
+            rehash(capacityFor(max(size, count)));
+        }
+    }
+
+    iterator begin() {
+        iterator it(this, 0);
+        it.skipFree();
+        return it;
+    }
+
+    const_iterator begin() const {
+        const_iterator it(this, 0);
+        it.skipFree();
+        return it;
+    }
+
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+    iterator find(const K& key) { return iterator(this, findSlot(key)); }
+    const_iterator find(const K& key) const { return const_iterator(this, findSlot(key)); }
+
+    /**
+     * @param key Key to look up
+     * @return The value stored for key
+     * @throws out_of_range if key is absent
+     */
+    V& at(const K& key) {
+        size_t slot = findSlot(key);
+        if (slot == slots.size()) {
+            throw std::out_of_range("Key not found in FlatEdgeMap");
+        }
+        return slots[slot].second;
+    }
+
+    const V& at(const K& key) const {
+        size_t slot = findSlot(key);
+        if (slot == slots.size()) {
+            throw std::out_of_range("Key not found in FlatEdgeMap");
+        }
+        return slots[slot].second;
+    }
+
+    /**
+     * Inserts key with a value built from args unless key is present.
+     * @return Iterator to the entry of key, and whether it was inserted
+     */
+    template <typename... Args>
+    pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        size_t slot = findSlot(key);
+        if (slot != slots.size()) {
+            return {iterator(this, slot), false};
+        }
+        if (slots.empty() || count + erased + 1 > maxUsed(slots.size())) {
+            rehash(capacityFor(count + 1));
+        }
+        slot = insertSlot(key);
+        if (states[slot] == ERASED) {
+            --erased;
+        }
+        states[slot] = FULL;
+        slots[slot] = value_type(key, V(std::forward<Args>(args)...));
+        ++count;
+        return {iterator(this, slot), true};
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    void erase(const_iterator position) {
+        size_t slot = position.slot;
+        states[slot] = ERASED;
+        slots[slot] = value_type();
+        --count;
+        ++erased;
+    }
+
+    size_t erase(const K& key) {
+        size_t slot = findSlot(key);
+        if (slot == slots.size()) {
+            return 0;
+        }
+        erase(const_iterator(this, slot));
+        return 1;
+    }
+
+    // Same entries, whatever the capacity and slot order
+    bool operator==(const FlatEdgeMap& other) const {
+        if (count != other.count) {
+            return false;
+        }
+        for (const auto& [key, value] : *this) {
+            auto found = other.find(key);
+            if (found == other.end() || !(found->second == value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const FlatEdgeMap& other) const { return !(*this == other); }
+};
+
+#endif
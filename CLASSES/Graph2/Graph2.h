@@ -12,8 +12,16 @@
 #include <sstream>       // For string stream
 #include <string>        // For string operations
 #include <stdexcept>     // For exceptions
+#include <cmath>         // For pow
+#include <algorithm>     // For remove_if
 #include <memory>        // For shared_ptr
+#include <cstdint>       // For uint32_t
+#include <tuple>         // For removeVertices and applyBatch
+#include <functional>    // For change listeners
 #include "../Community/Community.h"
+#include "../CsrGraph/CsrGraph.h"
+#include "../FileParsing/FileParsing.h"
+#include "FlatEdgeMap.h"
 using namespace std;
 
 
@@ -28,27 +36,93 @@ template <typename T>
 struct PairHash {
     std::size_t operator()(const std::pair<T, T>& p) const {
         // Get the hash of each element
-        auto h1 = std::hash<T>{}(p.first);
-        auto h2 = std::hash<T>{}(p.second);
-        
-        // Combine the hashes
-        return h1 ^ (h2 << 1);
+        uint64_t h1 = std::hash<T>{}(p.first);
+        uint64_t h2 = std::hash<T>{}(p.second);
+
+        // Combine the hashes. std::hash is the identity for integers, so
+        // the combination is run through the 64 bit finalizer of MurmurHash3:
+        // every input bit then reaches the low bits that pick a bucket.
+        // (h1 ^ (h2 << 1) mapped most pairs of small ids onto few values.)
+        uint64_t h = h1 * 0x9E3779B97F4A7C15ULL ^ h2;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return static_cast<std::size_t>(h);
     }
 };
 
 
 template <typename T>
 class Graph {
+public:
+    // Change events of a dynamic graph, see addChangeListener. Vertex events
+    // carry the vertex in from and to and a weight of 0.
+    enum class ChangeType { VertexAdded, VertexRemoved, EdgeAdded, EdgeRemoved };
+
+    struct Change {
+        ChangeType type;
+        T from;
+        T to;
+        double weight;
+    };
+
+    using ChangeListener = function<void(const Change&)>;
+
+    // Edge index: (a, b) with a < b -> weight, see FlatEdgeMap
+    using EdgeMap = FlatEdgeMap<pair<T, T>, double, PairHash<T>>;
+
 private:
+    // Listeners belong to the graph object they were added to: copies start
+    // without any and assigning a graph keeps the target's listeners
+    struct ChangeListeners {
+        vector<pair<size_t, ChangeListener>> entries;
+        size_t nextId = 0;
+
+        ChangeListeners() = default;
+        ChangeListeners(const ChangeListeners&) {}
+        ChangeListeners& operator=(const ChangeListeners&) { return *this; }
+    };
+
+    // Copies start from the source's count; assigning a graph counts as a
+    // modification of the target
+    struct ModificationCount {
+        uint64_t value = 0;
+
+        ModificationCount() = default;
+        ModificationCount(const ModificationCount& other) : value(other.value) {}
+        ModificationCount& operator=(const ModificationCount&) { ++value; return *this; }
+    };
+
     unordered_map<T, vector<pair<T,double>>> adjacencyList;
     
     double totalWeight = 0;
     unordered_map<T, double> weightedDegrees; // v , sum(all connected edges)
-    unordered_map<pair<T, T>, double, PairHash<T>> edgeLookup; // for quick lookup,
+    EdgeMap edgeLookup; // for quick lookup,
     set<T> vertices;
     //stores a pair of 2 vertices and their corresponding edge weight,
-    // we also define the "type" for the hash in the unordered_map
+    // we also define the "type" for the hash in the EdgeMap
     // **WHEN YOU STORE IT SHOULD BE a,b where a<b**.
+    ChangeListeners listeners;
+    ModificationCount modifications;
+
+    bool notifying() const { return !listeners.entries.empty(); }
+
+    void notify(ChangeType type, const T& from, const T& to, double weight) {
+        Change change{type, from, to, weight};
+        for(const auto& [id, listener] : listeners.entries) {
+            listener(change);
+        }
+    }
+
+    void insertVertex(const T& vertex) {
+        ++modifications.value;
+        vertices.insert(vertex);
+        adjacencyList[vertex] = std::vector<std::pair<T,double>>();
+        weightedDegrees[vertex] = 0.0;  // Initialize other data structures
+    }
+
 public:
     Graph() = default;
     
@@ -126,6 +200,184 @@ public:
         file.close();
     }
     
+    // Edge between two positions of the vertex list passed to buildBulk
+    struct BulkEdge {
+        uint32_t from;
+        uint32_t to;
+        double weight;
+    };
+
+    // Bulk loader for the same file format as Graph(string filename).
+    // Reads the file in large chunks and parses with from_chars into a flat
+    // edge buffer, then builds the graph from it with buildBulk. With
+    // numThreads > 1 (0 for every hardware thread) the edge lines are split
+    // into newline-aligned chunks parsed on their own threads; the result
+    // and the reported errors are the same as for a single thread.
+    static Graph<T> loadBulk(const string& filename, unsigned numThreads = 1) {
+        vector<T> slotVertex;
+        vector<BulkEdge> edges;
+        readBulkFile(filename, numThreads, slotVertex, edges);
+        return buildBulk(slotVertex, edges);
+    }
+
+    // Loads a graph file straight into a CSR snapshot, without building the
+    // hash-based graph first. Same result as loadBulk(filename).freeze()
+    // and the same errors, parsed on numThreads threads like loadBulk.
+    static CsrGraph<T> loadCsr(const string& filename, unsigned numThreads = 1) {
+        vector<T> slotVertex;
+        vector<BulkEdge> edges;
+        readBulkFile(filename, numThreads, slotVertex, edges);
+        if (slotVertex.size() > UINT32_MAX) {
+            throw std::length_error("Too many vertices for a CSR snapshot");
+        }
+
+        // Dense ids follow the sorted vertex order, like freeze()
+        size_t numVertices = slotVertex.size();
+        vector<uint32_t> slotsById(numVertices);
+        for (size_t slot = 0; slot < numVertices; ++slot) {
+            slotsById[slot] = static_cast<uint32_t>(slot);
+        }
+        sort(slotsById.begin(), slotsById.end(), [&](uint32_t a, uint32_t b) {
+            return slotVertex[a] < slotVertex[b];
+        });
+        vector<T> idToVertex(numVertices);
+        vector<uint32_t> idOf(numVertices);
+        for (size_t id = 0; id < numVertices; ++id) {
+            idToVertex[id] = slotVertex[slotsById[id]];
+            idOf[slotsById[id]] = static_cast<uint32_t>(id);
+        }
+
+        // Count, prefix sum and scatter both directions of every edge; a
+        // self-loop lands twice in its own slice, as in the adjacency list
+        vector<uint64_t> offsets(numVertices + 1, 0);
+        double totalWeight = 0.0;
+        for (const BulkEdge& edge : edges) {
+            ++offsets[idOf[edge.from] + 1];
+            ++offsets[idOf[edge.to] + 1];
+            totalWeight += edge.weight;
+        }
+        for (size_t id = 0; id < numVertices; ++id) {
+            offsets[id + 1] += offsets[id];
+        }
+        vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+        vector<pair<uint32_t, double>> entries(offsets.back());
+        for (const BulkEdge& edge : edges) {
+            uint32_t from = idOf[edge.from];
+            uint32_t to = idOf[edge.to];
+            entries[next[from]++] = {to, edge.weight};
+            entries[next[to]++] = {from, edge.weight};
+        }
+
+        // Sort every slice and reject duplicates like buildBulk
+        vector<uint32_t> targets(entries.size());
+        vector<double> weights(entries.size());
+        for (size_t id = 0; id < numVertices; ++id) {
+            auto first = entries.begin() + offsets[id];
+            auto last = entries.begin() + offsets[id + 1];
+            sort(first, last);
+            for (auto run = first; run != last;) {
+                auto runEnd = run;
+                while (runEnd != last && runEnd->first == run->first) ++runEnd;
+                size_t allowed = run->first == id ? 2 : 1;
+                if (static_cast<size_t>(runEnd - run) > allowed) {
+                    throw std::runtime_error("Duplicate edge: " + describeValue(idToVertex[id]) +
+                                             " - " + describeValue(idToVertex[run->first]));
+                }
+                run = runEnd;
+            }
+            for (uint64_t e = offsets[id]; e < offsets[id + 1]; ++e) {
+                targets[e] = entries[e].first;
+                weights[e] = entries[e].second;
+            }
+        }
+
+        return CsrGraph<T>(std::move(idToVertex), std::move(offsets), std::move(targets),
+                           std::move(weights), totalWeight, edges.size());
+    }
+
+    // Builds a graph from distinct vertices and edges given as positions in
+    // that vertex list, as produced by a loader or a generator. Reserves
+    // every hash table and adjacency vector from the known counts and adds
+    // the edges in one pass; duplicate edges throw like in the constructor.
+    static Graph<T> buildBulk(const vector<T>& slotVertex, const vector<BulkEdge>& edges) {
+        Graph<T> graph;
+        size_t numVertices = slotVertex.size();
+        size_t numEdges = edges.size();
+        vector<uint32_t> degrees(numVertices, 0);
+        for (const BulkEdge& edge : edges) {
+            if (edge.from >= numVertices || edge.to >= numVertices) {
+                throw std::out_of_range("Edge endpoint outside of the vertex list");
+            }
+            if (edge.weight < 0) {
+                throw std::invalid_argument("Weight can't be negative");
+            }
+            ++degrees[edge.from];
+            ++degrees[edge.to];
+        }
+
+        // Create every vertex with exactly sized neighbor storage
+        graph.adjacencyList.reserve(numVertices);
+        graph.weightedDegrees.reserve(numVertices);
+        graph.edgeLookup.reserve(numEdges);
+        vector<vector<pair<T,double>>*> neighborsOf(numVertices);
+        vector<double> weightedDegreeOf(numVertices, 0.0);
+        for (size_t slot = 0; slot < numVertices; ++slot) {
+            auto created = graph.adjacencyList.try_emplace(slotVertex[slot]);
+            if (!created.second) {
+                throw std::invalid_argument("Vertex already exists in graph");
+            }
+            // saveToFile writes vertices in sorted order, so the hint is usually exact
+            graph.vertices.emplace_hint(graph.vertices.end(), slotVertex[slot]);
+            neighborsOf[slot] = &created.first->second;
+            neighborsOf[slot]->reserve(degrees[slot]);
+        }
+
+        // Build adjacency, edgeLookup and the weight sums in one pass
+        for (const BulkEdge& edge : edges) {
+            const T& from = slotVertex[edge.from];
+            const T& to = slotVertex[edge.to];
+            if (!graph.edgeLookup.try_emplace(graph.makeNomimalEdge(from, to), edge.weight).second) {
+                throw std::runtime_error("Duplicate edge: " + describeValue(from) + " - " + describeValue(to));
+            }
+
+            graph.totalWeight += edge.weight;
+            neighborsOf[edge.from]->emplace_back(to, edge.weight);
+            neighborsOf[edge.to]->emplace_back(from, edge.weight);
+            weightedDegreeOf[edge.from] += edge.weight;
+            weightedDegreeOf[edge.to] += edge.weight;
+        }
+
+        for (size_t slot = 0; slot < numVertices; ++slot) {
+            graph.weightedDegrees.emplace(slotVertex[slot], weightedDegreeOf[slot]);
+        }
+
+        return graph;
+    }
+    
+    // Dynamic mode: the listener is called with every change made through
+    // addVertex, addEdge, removeEdge, removeVertex, removeVertices and
+    // applyBatch, after the change is applied. Removing a vertex reports
+    // each of its edges, then the vertex; the compound calls report once all
+    // of their changes are applied. Loaders and copies report nothing.
+    size_t addChangeListener(ChangeListener listener) {
+        size_t id = listeners.nextId++;
+        listeners.entries.emplace_back(id, std::move(listener));
+        return id;
+    }
+
+    void removeChangeListener(size_t id) {
+        auto& entries = listeners.entries;
+        entries.erase(
+            std::remove_if(
+                entries.begin(), entries.end(),
+                [id](const pair<size_t, ChangeListener>& entry) {
+                    return entry.first == id;
+                }
+            ),
+            entries.end()
+        );
+    }
+
     //vertex operations
 
     bool hasVertex(const T& vertex) const {
@@ -136,41 +388,46 @@ public:
         if (hasVertex(vertex)) {
             throw std::invalid_argument("Vertex already exists in graph");
         }
-        vertices.insert(vertex);
-        adjacencyList[vertex] = std::vector<std::pair<T,double>>();
-        weightedDegrees[vertex] = 0.0;  // Initialize other data structures
+        insertVertex(vertex);
+        if(notifying()) {
+            notify(ChangeType::VertexAdded, vertex, vertex, 0.0);
+        }
     }
     
     void removeVertex(const T& vertex) {
         // check if vertex exists
         if(!hasVertex(vertex)) { return; }
+        ++modifications.value;
         
-        //2 remove the sum of all edges for vertex from totalWeight
-        double weightedDegreeForVertex = weightedDegrees.at(vertex);
-        totalWeight -= weightedDegreeForVertex;
-        
-        std::vector<std::pair<T,T>> keysToRemove;
-        
-        //3 find keys to remove from edgeLookup.
+        //1 with listeners, keep the edges to report: every neighbor once, a
+        // self-loop (listed twice) once
+        vector<pair<T,double>> removedEdges;
+        if(notifying()) {
+            bool loopListed = false;
+            for(const auto& [neighbor, weight] : adjacencyList.at(vertex)) {
+                if(neighbor == vertex) {
+                    loopListed = !loopListed;
+                    if(!loopListed) { continue; }
+                }
+                removedEdges.emplace_back(neighbor, weight);
+            }
+        }
         
-        //a Decrement weightedDegrees[neighbor] by weight for each neighbor
+        //2 for each neighbor: remove the edge weight from totalWeight, erase
+        // the edge from edgeLookup, decrement weightedDegrees[neighbor] and
+        // drop vertex from its neighbors. Only the neighbors' lists are
+        // touched, so this is O(sum of their degrees).
         for(const auto& [neighbor, weight] : adjacencyList.at(vertex)) {
-            auto keyToRemove = vertex < neighbor ? make_pair(vertex,neighbor) : make_pair(neighbor,vertex);
-            keysToRemove.push_back(keyToRemove);
+            edgeLookup.erase(makeNomimalEdge(vertex, neighbor));
+            if(neighbor == vertex) {
+                // a self-loop is listed twice but added to totalWeight once
+                totalWeight -= weight / 2;
+                continue;
+            }
+            totalWeight -= weight;
             
-            // Update weightedDegrees for the neighbor
             weightedDegrees.at(neighbor) -= weight;
-        }
-        
-        //4 Remove keys from edgeLookup
-        for(const auto& pair : keysToRemove) {
-            edgeLookup.erase(pair);
-        }
-        
-        //5 remove v from other vertices neighbors array
-        for(auto& [v, neighbors] : adjacencyList) {
-            if(v == vertex) {continue;}
-            
+            auto& neighbors = adjacencyList.at(neighbor);
             neighbors.erase(
                 std::remove_if(
                     neighbors.begin(), neighbors.end(),
@@ -182,10 +439,116 @@ public:
             );
         }
         
-        //6 adjacencyList erase vertex , weightedDegrees erase vertex,
+        //3 adjacencyList erase vertex , weightedDegrees erase vertex,
         adjacencyList.erase(vertex);
         weightedDegrees.erase(vertex);
         vertices.erase(vertex);
+        
+        //4 report the removed edges, then the vertex
+        for(const auto& [neighbor, weight] : removedEdges) {
+            notify(ChangeType::EdgeRemoved, vertex, neighbor, weight);
+        }
+        if(notifying()) {
+            notify(ChangeType::VertexRemoved, vertex, vertex, 0.0);
+        }
+    }
+    
+    // Removes many vertices at once, with the same result as calling
+    // removeVertex on each. Every affected neighbor list is compacted in a
+    // single pass, however many of its entries are removed.
+    void removeVertices(const set<T>& toRemove) {
+        // visited in the order of the set, so the result does not depend on
+        // the order of the hash tables
+        vector<T> existing;
+        unordered_set<T> removed;
+        removed.reserve(toRemove.size());
+        for(const auto& vertex : toRemove) {
+            if(hasVertex(vertex)) {
+                existing.push_back(vertex);
+                removed.insert(vertex);
+            }
+        }
+        if(existing.empty()) { return; }
+        ++modifications.value;
+        
+        //1 erase every edge touching a removed vertex and collect the
+        // (remaining vertex, removed neighbor, weight) entries to strip
+        vector<tuple<T, T, double>> cut;
+        vector<tuple<T, T, double>> removedEdges;  // only with listeners
+        for(const auto& vertex : existing) {
+            bool loopListed = false;
+            for(const auto& [neighbor, weight] : adjacencyList.at(vertex)) {
+                bool neighborRemoved = removed.count(neighbor) > 0;
+                // edges between two removed vertices are seen from both ends,
+                // a self-loop is listed twice; both are subtracted once
+                if(neighbor == vertex) {
+                    totalWeight -= weight / 2;
+                    loopListed = !loopListed;
+                    if(notifying() && loopListed) {
+                        removedEdges.emplace_back(vertex, neighbor, weight);
+                    }
+                } else if(!neighborRemoved || vertex < neighbor) {
+                    totalWeight -= weight;
+                    if(notifying()) {
+                        removedEdges.emplace_back(vertex, neighbor, weight);
+                    }
+                }
+                edgeLookup.erase(makeNomimalEdge(vertex, neighbor));
+                if(!neighborRemoved) {
+                    cut.emplace_back(neighbor, vertex, weight);
+                }
+            }
+        }
+        
+        //2 compact the neighbor list of every remaining vertex that lost
+        // edges, once. A few lost neighbors are matched directly, many (a
+        // hub) through the removed set.
+        sort(cut.begin(), cut.end(), [](const tuple<T, T, double>& x, const tuple<T, T, double>& y) {
+            return get<0>(x) < get<0>(y);
+        });
+        for(size_t first = 0; first < cut.size();) {
+            const T& vertex = get<0>(cut[first]);
+            size_t last = first;
+            double lostWeight = 0;
+            for(; last < cut.size() && get<0>(cut[last]) == vertex; ++last) {
+                lostWeight += get<2>(cut[last]);
+            }
+            weightedDegrees.at(vertex) -= lostWeight;
+            auto& neighbors = adjacencyList.at(vertex);
+            neighbors.erase(
+                std::remove_if(
+                    neighbors.begin(), neighbors.end(),
+                    [&](const std::pair<T, double>& edge) {
+                        if(last - first > 8) {
+                            return removed.count(edge.first) > 0;
+                        }
+                        for(size_t i = first; i < last; ++i) {
+                            if(get<1>(cut[i]) == edge.first) { return true; }
+                        }
+                        return false;
+                    }
+                ),
+                neighbors.end()
+            );
+            first = last;
+        }
+        
+        //3 drop the removed vertices themselves
+        for(const auto& vertex : existing) {
+            adjacencyList.erase(vertex);
+            weightedDegrees.erase(vertex);
+            vertices.erase(vertex);
+        }
+        
+        //4 report the removed edges, then the vertices
+        for(const auto& [from, to, weight] : removedEdges) {
+            notify(ChangeType::EdgeRemoved, from, to, weight);
+        }
+        if(notifying()) {
+            for(const auto& vertex : existing) {
+                notify(ChangeType::VertexRemoved, vertex, vertex, 0.0);
+            }
+        }
     }
     
     size_t getVertexCount() const { return vertices.size(); }
@@ -234,6 +597,7 @@ public:
 
         if(!hasEdge(from,to)) {
             // Data structures affected: adjancencyList, totalWeight, weightedDegrees, edgeLookup
+            ++modifications.value;
             
             //1 First update graph's total weight
             totalWeight += weight;
@@ -249,6 +613,10 @@ public:
             //4 update edgeLookup
             pair<T,T> key = makeNomimalEdge(from,to);
             edgeLookup[key] = weight;
+
+            if(notifying()) {
+                notify(ChangeType::EdgeAdded, from, to, weight);
+            }
         } else {
             throw std::logic_error("Edge already exists");
         }
@@ -258,6 +626,7 @@ public:
         if(!hasEdge(from, to)) {
             throw std::logic_error("Edge does not exist");
         }
+        ++modifications.value;
         
         // Get the weight
         const auto key = makeNomimalEdge(from, to);
@@ -299,20 +668,193 @@ public:
             ),
             toNeighbors.end()
         );
+
+        if(notifying()) {
+            notify(ChangeType::EdgeRemoved, from, to, weight);
+        }
     }
-    
+
+    // Apply a batch of edge updates: every delete, then every insert, so a
+    // batch can change a weight by deleting and re-inserting the edge. Throws
+    // what removeEdge/addEdge would, also for an edge repeated within the
+    // deletes or the inserts, and then leaves the graph unchanged. Updates
+    // are grouped by vertex: each touched neighbor list is compacted and
+    // grown once, with one weightedDegrees update per vertex. A delete costs
+    // one edgeLookup find and erase, an insert one try_emplace.
+    void applyBatch(const vector<tuple<T, T, double>>& inserts, const vector<pair<T, T>>& deletes) {
+        using EdgeIterator = typename EdgeMap::iterator;
+
+        // grown up front: a rehash would invalidate the iterators kept below
+        edgeLookup.reserve(edgeLookup.size() + inserts.size());
+
+        //1 find the deleted edges; sorted, so a repeated edge is adjacent
+        vector<pair<T,T>> deleteKeys;
+        deleteKeys.reserve(deletes.size());
+        for(const auto& [from, to] : deletes) {
+            deleteKeys.push_back(makeNomimalEdge(from, to));
+        }
+        sort(deleteKeys.begin(), deleteKeys.end());
+        vector<EdgeIterator> deleted;
+        deleted.reserve(deleteKeys.size());
+        for(size_t i = 0; i < deleteKeys.size(); ++i) {
+            if(i > 0 && deleteKeys[i] == deleteKeys[i - 1]) {
+                throw std::logic_error("Edge deleted twice in batch");
+            }
+            auto edge = edgeLookup.find(deleteKeys[i]);
+            if(edge == edgeLookup.end()) {
+                throw std::logic_error("Edge does not exist");
+            }
+            deleted.push_back(edge);
+        }
+
+        //2 add the inserted edges to edgeLookup. A deleted edge that is
+        // inserted again keeps its entry and gets the new weight in 3; any
+        // other edge already present, including one inserted earlier in the
+        // batch, is an error and the new entries are taken out again.
+        for(const auto& [from, to, weight] : inserts) {
+            if (weight < 0) {
+                throw std::invalid_argument("Weight can't be negative");
+            }
+        }
+        vector<double> reinsertedWeight(deleted.size(), -1);  // -1: not inserted again
+        vector<EdgeIterator> added;
+        added.reserve(inserts.size());
+        for(const auto& [from, to, weight] : inserts) {
+            pair<T,T> key = makeNomimalEdge(from, to);
+            auto [edge, isNew] = edgeLookup.try_emplace(key, weight);
+            if(isNew) {
+                added.push_back(edge);
+                continue;
+            }
+            auto deletedKey = lower_bound(deleteKeys.begin(), deleteKeys.end(), key);
+            if(deletedKey == deleteKeys.end() || *deletedKey != key ||
+               reinsertedWeight[deletedKey - deleteKeys.begin()] >= 0) {
+                for(auto newEdge : added) {
+                    edgeLookup.erase(newEdge);
+                }
+                throw std::logic_error("Edge already exists");
+            }
+            reinsertedWeight[deletedKey - deleteKeys.begin()] = weight;
+        }
+        ++modifications.value;
+
+        //3 drop the deleted edges and list the changes of every endpoint,
+        // grouped by vertex with its deleted neighbors (sorted, for binary
+        // search) before its inserted ones (in batch order, like a run of
+        // addEdge calls). A self-loop is listed twice, as in addEdge.
+        struct Update {
+            T vertex;
+            T neighbor;
+            double weight;
+            size_t order;  // 0 for a delete, 1 + position for an insert
+        };
+        vector<Update> updates;
+        updates.reserve(2 * (deletes.size() + inserts.size()));
+        vector<tuple<T, T, double>> removedEdges;  // only with listeners
+        for(size_t i = 0; i < deleted.size(); ++i) {
+            const auto [from, to] = deleted[i]->first;
+            double weight = deleted[i]->second;
+            totalWeight -= weight;
+            updates.push_back({from, to, weight, 0});
+            updates.push_back({to, from, weight, 0});
+            if(notifying()) {
+                removedEdges.emplace_back(from, to, weight);
+            }
+            if(reinsertedWeight[i] < 0) {
+                edgeLookup.erase(deleted[i]);
+            } else {
+                deleted[i]->second = reinsertedWeight[i];
+            }
+        }
+        for(size_t i = 0; i < inserts.size(); ++i) {
+            const auto& [from, to, weight] = inserts[i];
+            totalWeight += weight;
+            updates.push_back({from, to, weight, 1 + i});
+            updates.push_back({to, from, weight, 1 + i});
+        }
+        sort(updates.begin(), updates.end(), [](const Update& x, const Update& y) {
+            return x.vertex < y.vertex;
+        });
+
+        //4 apply each vertex's changes at once: one weightedDegrees update,
+        // one compaction and one growth of its neighbor list
+        vector<T> addedVertices;
+        for(size_t first = 0; first < updates.size();) {
+            const T& vertex = updates[first].vertex;
+            size_t last = first;
+            size_t firstInsert = first;
+            double weightChange = 0;
+            for(; last < updates.size() && updates[last].vertex == vertex; ++last) {}
+            // ordered within the group only, a much smaller sort
+            sort(updates.begin() + first, updates.begin() + last, [](const Update& x, const Update& y) {
+                return x.order < y.order || (x.order == y.order && x.neighbor < y.neighbor);
+            });
+            for(size_t i = first; i < last; ++i) {
+                if(updates[i].order == 0) {
+                    weightChange -= updates[i].weight;
+                    ++firstInsert;
+                } else {
+                    weightChange += updates[i].weight;
+                }
+            }
+            if(adjacencyList.find(vertex) == adjacencyList.end()) {
+                insertVertex(vertex);
+                addedVertices.push_back(vertex);
+            }
+            weightedDegrees.at(vertex) += weightChange;
+            auto& neighbors = adjacencyList.at(vertex);
+            if(firstInsert > first) {
+                auto lostBegin = updates.begin() + first;
+                auto lostEnd = updates.begin() + firstInsert;
+                neighbors.erase(
+                    std::remove_if(
+                        neighbors.begin(), neighbors.end(),
+                        [&](const std::pair<T, double>& edge) {
+                            auto lost = lower_bound(lostBegin, lostEnd, edge.first,
+                                [](const Update& update, const T& neighbor) {
+                                    return update.neighbor < neighbor;
+                                });
+                            return lost != lostEnd && lost->neighbor == edge.first;
+                        }
+                    ),
+                    neighbors.end()
+                );
+            }
+            // grow geometrically, so many small batches stay amortized O(1)
+            if(neighbors.size() + (last - firstInsert) > neighbors.capacity()) {
+                neighbors.reserve(max(neighbors.size() + (last - firstInsert), 2 * neighbors.capacity()));
+            }
+            for(size_t i = firstInsert; i < last; ++i) {
+                neighbors.emplace_back(updates[i].neighbor, updates[i].weight);
+            }
+            first = last;
+        }
+
+        //5 report the deleted edges, the new vertices and the inserted edges
+        if(notifying()) {
+            for(const auto& [from, to, weight] : removedEdges) {
+                notify(ChangeType::EdgeRemoved, from, to, weight);
+            }
+            for(const auto& vertex : addedVertices) {
+                notify(ChangeType::VertexAdded, vertex, vertex, 0.0);
+            }
+            for(const auto& [from, to, weight] : inserts) {
+                notify(ChangeType::EdgeAdded, from, to, weight);
+            }
+        }
+    }
+
     double getEdgeWeight(const T& from, const T& to) const {
-        if(!hasEdge(from,to)) {
+        auto edge = edgeLookup.find(makeNomimalEdge(from,to));
+        if(edge == edgeLookup.end()) {
             throw std::logic_error("Edge does not exist");
         }
-
-        const auto key = makeNomimalEdge(from,to);
-        return edgeLookup.at(key);
+        return edge->second;
     }
     
     size_t getEdgeCount() const { return edgeLookup.size(); }
 
-    const unordered_map<pair<T,T>, double, PairHash<T>>& getEdgesWithWeight() const {
+    const EdgeMap& getEdgesWithWeight() const {
         return edgeLookup;
     }
 
@@ -330,6 +872,10 @@ public:
     }
     
     double getTotalWeight() const { return totalWeight; }
+
+    // Grows with every change to the vertices or edges, so a cached result
+    // can tell whether the graph changed since it was computed
+    uint64_t getModificationCount() const { return modifications.value; }
     
     shared_ptr<Graph<T>> createSubGraph(set<T> vertices) {
         shared_ptr<Graph<T>> subGraph = make_shared<Graph<T>>();
@@ -356,6 +902,47 @@ public:
         
     }
     
+    // Compact the graph into an immutable CSR snapshot for read-heavy analytics.
+    // Dense ids follow the (sorted) order of getVertices().
+    CsrGraph<T> freeze() const {
+        if (vertices.size() > UINT32_MAX) {
+            throw std::length_error("Too many vertices for a CSR snapshot");
+        }
+
+        vector<T> idToVertex(vertices.begin(), vertices.end());
+        unordered_map<T, uint32_t> vertexToId;
+        vertexToId.reserve(idToVertex.size());
+        for (size_t id = 0; id < idToVertex.size(); ++id) {
+            vertexToId.emplace(idToVertex[id], static_cast<uint32_t>(id));
+        }
+
+        vector<uint64_t> offsets(idToVertex.size() + 1, 0);
+        for (size_t id = 0; id < idToVertex.size(); ++id) {
+            offsets[id + 1] = offsets[id] + adjacencyList.at(idToVertex[id]).size();
+        }
+
+        vector<uint32_t> targets(offsets.back());
+        vector<double> weights(offsets.back());
+        vector<pair<uint32_t, double>> row;
+        for (size_t id = 0; id < idToVertex.size(); ++id) {
+            row.clear();
+            for (const auto& [neighbor, weight] : adjacencyList.at(idToVertex[id])) {
+                row.emplace_back(vertexToId.at(neighbor), weight);
+            }
+            sort(row.begin(), row.end());
+
+            uint64_t e = offsets[id];
+            for (const auto& [target, weight] : row) {
+                targets[e] = target;
+                weights[e] = weight;
+                ++e;
+            }
+        }
+
+        return CsrGraph<T>(std::move(idToVertex), std::move(offsets), std::move(targets),
+                           std::move(weights), totalWeight, getEdgeCount());
+    }
+    
     void saveToFile(string filename) {
         ofstream file(filename);
         if (!file.is_open()) {
@@ -382,9 +969,217 @@ public:
         file.close();
     }
 
+    // Save a CSR snapshot in the binary format; load it back with CsrGraph<T>::loadBinary,
+    // which memory maps the file instead of re-parsing it.
+    void saveToBinaryFile(string filename) const {
+        freeze().saveBinary(filename);
+    }
+
     double calculateModularity(const vector<Community<T>>& communities) {
         // Q= ∑_c [ L_c/m - (K_c/2m)^2 ]
         
+        // Disjoint communities (the usual case) are scored in one pass over
+        // the adjacency lists through a node -> community label map built once
+        unordered_map<T, int> nodeToCommunity;
+        for (size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for (const auto& node : communities[communityId].getNodes()) {
+                if (!nodeToCommunity.emplace(node, static_cast<int>(communityId)).second) {
+                    // a node in several communities: score each community on its own
+                    return calculateOverlappingModularity(communities);
+                }
+            }
+        }
+        return calculateModularity(nodeToCommunity);
+    }
+
+    // Modularity of the partition given as node -> community label (labels
+    // are small non-negative ints; negative labels and nodes missing from
+    // the map belong to no community). L_c and K_c for all communities are
+    // accumulated in flat arrays during a single pass over the adjacency lists.
+    double calculateModularity(const unordered_map<T, int>& nodeToCommunity) const {
+        double m = getTotalWeight();
+        if (m <= 0) {
+            return 0.0;
+        }
+
+        int maxLabel = -1;
+        for (const auto& [node, label] : nodeToCommunity) {
+            maxLabel = max(maxLabel, label);
+        }
+        vector<double> L(maxLabel + 1, 0.0);
+        vector<double> K(maxLabel + 1, 0.0);
+
+        // K_c (sum of weighted degrees)
+        for (const auto& [node, label] : nodeToCommunity) {
+            if (label < 0) continue;
+            auto degree = weightedDegrees.find(node);
+            if (degree != weightedDegrees.end()) {
+                K[label] += degree->second;
+            }
+        }
+
+        // L_c (internal edge weights, each edge once from its lower endpoint, self-loops excluded)
+        for (const auto& [from, neighbors] : adjacencyList) {
+            auto first = nodeToCommunity.find(from);
+            if (first == nodeToCommunity.end() || first->second < 0) continue;
+            int label = first->second;
+            for (const auto& [to, weight] : neighbors) {
+                if (!(from < to)) continue;
+                auto second = nodeToCommunity.find(to);
+                if (second != nodeToCommunity.end() && second->second == label) {
+                    L[label] += weight;
+                }
+            }
+        }
+
+        double modularity = 0.0;
+        for (int c = 0; c <= maxLabel; ++c) {
+            modularity += (L[c] / m) - pow((K[c] / (2.0 * m)), 2);
+        }
+        return modularity;
+    }
+
+private:
+    // Reads the vertex list and edge lines of a graph file for loadBulk and
+    // loadCsr: vertices in file order, edges as positions in that list.
+    static void readBulkFile(const string& filename, unsigned numThreads,
+                             vector<T>& slotVertex, vector<BulkEdge>& edges) {
+        ChunkedLineReader reader(filename);
+        const char* begin;
+        const char* end;
+
+        // Read the number of vertices
+        size_t numVertices;
+        if (!reader.nextLine(begin, end) || !parseToken(begin, end, numVertices)) {
+            throw std::runtime_error("Error reading number of vertices");
+        }
+
+        // Read the vertices, giving each one a dense slot index
+        unordered_map<T, uint32_t> slotOf;
+        slotOf.reserve(numVertices);
+        slotVertex.clear();
+        slotVertex.reserve(numVertices);
+
+        if (!reader.nextLine(begin, end)) {
+            throw std::runtime_error("Error reading vertices");
+        }
+        T vertex;
+        while (parseToken(begin, end, vertex)) {
+            if (!slotOf.emplace(vertex, static_cast<uint32_t>(slotVertex.size())).second) {
+                throw std::invalid_argument("Vertex already exists in graph");
+            }
+            slotVertex.push_back(vertex);
+        }
+
+        // Check if we read the correct number of vertices
+        if (slotVertex.size() != numVertices) {
+            throw std::runtime_error("Mismatch in vertex count: expected " +
+                                     to_string(numVertices) + ", got " +
+                                     to_string(slotVertex.size()));
+        }
+
+        // Read the number of edges
+        size_t numEdges;
+        if (!reader.nextLine(begin, end) || !parseToken(begin, end, numEdges)) {
+            throw std::runtime_error("Error reading number of edges");
+        }
+
+        if (numThreads == 1) {
+            // Read the edges into a flat buffer of slot indices
+            edges.assign(numEdges, BulkEdge{});
+            for (size_t i = 0; i < numEdges; ++i) {
+                if (!reader.nextLine(begin, end)) {
+                    throw std::runtime_error("Expected " + to_string(numEdges) +
+                                             " edges, but only found " + to_string(i));
+                }
+                if (!parseBulkEdge(begin, end, slotOf, edges[i])) {
+                    throw std::runtime_error("Error parsing edge at line " + to_string(i+4));
+                }
+            }
+            return;
+        }
+
+        // Parse the remaining lines chunk by chunk. Each chunk keeps its
+        // edges and stops at its first bad line; the earliest bad line within
+        // the first numEdges edge lines is reported, as a single thread would.
+        struct ChunkResult {
+            vector<BulkEdge> edges;
+            size_t failedLine = SIZE_MAX;   // index within the chunk
+            exception_ptr failure;          // null for a syntax error
+        };
+        vector<ChunkResult> chunks(numThreads == 0 ? max(1u, thread::hardware_concurrency()) : numThreads);
+        parseChunksInParallel(filename, reader.getOffset(), numThreads,
+            [&](size_t chunk, const char* chunkBegin, const char* chunkEnd) {
+                ChunkResult& result = chunks[chunk];
+                result.edges.reserve(numEdges / chunks.size() + 1);
+                forEachLine(chunkBegin, chunkEnd, [&](const char* lineBegin, const char* lineEnd) {
+                    BulkEdge edge;
+                    try {
+                        if (!parseBulkEdge(lineBegin, lineEnd, slotOf, edge)) {
+                            result.failedLine = result.edges.size();
+                            return false;
+                        }
+                    } catch (...) {
+                        result.failedLine = result.edges.size();
+                        result.failure = current_exception();
+                        return false;
+                    }
+                    result.edges.push_back(edge);
+                    return true;
+                });
+            });
+
+        // Merge in file order, ignoring anything past the last edge line
+        edges.clear();
+        edges.reserve(numEdges);
+        for (ChunkResult& result : chunks) {
+            size_t needed = numEdges - edges.size();
+            if (result.failedLine < needed) {
+                if (result.failure) {
+                    rethrow_exception(result.failure);
+                }
+                throw std::runtime_error("Error parsing edge at line " +
+                                         to_string(edges.size() + result.failedLine + 4));
+            }
+            size_t taken = min(needed, result.edges.size());
+            edges.insert(edges.end(), result.edges.begin(), result.edges.begin() + taken);
+            vector<BulkEdge>().swap(result.edges);
+        }
+        if (edges.size() < numEdges) {
+            throw std::runtime_error("Expected " + to_string(numEdges) +
+                                     " edges, but only found " + to_string(edges.size()));
+        }
+    }
+
+    // Parses one "from to weight" line into slot indices. Returns false on
+    // a syntax error and throws for an unknown vertex or a negative weight.
+    static bool parseBulkEdge(const char* begin, const char* end,
+                              const unordered_map<T, uint32_t>& slotOf, BulkEdge& edge) {
+        T from, to;
+        double weight;
+        if (!parseToken(begin, end, from) || !parseToken(begin, end, to) ||
+            !parseToken(begin, end, weight)) {
+            return false;
+        }
+
+        auto fromSlot = slotOf.find(from);
+        if (fromSlot == slotOf.end()) {
+            throw std::runtime_error("Vertex not found: " + describeValue(from));
+        }
+        auto toSlot = slotOf.find(to);
+        if (toSlot == slotOf.end()) {
+            throw std::runtime_error("Vertex not found: " + describeValue(to));
+        }
+        if (weight < 0) {
+            throw std::invalid_argument("Weight can't be negative");
+        }
+
+        edge = BulkEdge{fromSlot->second, toSlot->second, weight};
+        return true;
+    }
+
+    // Per-community scoring for covers where a node may appear in several communities
+    double calculateOverlappingModularity(const vector<Community<T>>& communities) const {
         // m is total weight divided by 2 (for undirected graph)
         double m = getTotalWeight();
         
@@ -0,0 +1,278 @@
+#ifndef INCREMENTALCOMMUNITYMAINTAINER_H
+#define INCREMENTALCOMMUNITYMAINTAINER_H
+
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+using namespace std;
+
+
+// Modularity and community weights of a disjoint partition of a dynamic
+// Graph<T>, kept current while the graph changes.
+//
+// The maintainer listens to the graph's change events (see
+// Graph<T>::addChangeListener). Like ModularityTracker it stores L_c
+// (internal edge weight, self-loops excluded) and K_c (sum of weighted
+// degrees) per community, plus their sums, so an added or removed edge only
+// touches the communities of its two endpoints: O(1) per edge instead of
+// rescoring the whole partition. The internal and external weights of every
+// Community are updated the same way and always equal what
+// Community::calculateWeights would give for the current graph. Moving a
+// node between communities reprocesses only that node's neighbor list.
+//
+// Vertices added to the graph belong to no community until moved into one;
+// removed vertices leave their community. Scores match
+// Graph<T>::calculateModularity for the current partition.
+template <typename T>
+class IncrementalCommunityMaintainer {
+private:
+    shared_ptr<Graph<T>> graph;
+    size_t listenerId;
+    // weights always current; stamped with the graph's modification count
+    // when handed out, see getCommunities
+    mutable vector<Community<T>> communities;
+    mutable uint64_t stampedModificationCount = 0;
+    unordered_map<T, int> labels;       // member -> community, nodes without one are absent
+    vector<double> internalWeights;     // L_c
+    vector<double> totalDegrees;        // K_c
+    double m = 0.0;
+    double internalSum = 0.0;           // sum of L_c
+    double squaredDegreeSum = 0.0;      // sum of K_c^2
+
+    int labelOf(const T& node) const {
+        auto it = labels.find(node);
+        return it == labels.end() ? -1 : it->second;
+    }
+
+    void ensureCommunity(int label) {
+        if (label >= static_cast<int>(communities.size())) {
+            size_t first = communities.size();
+            communities.resize(label + 1);
+            internalWeights.resize(label + 1, 0.0);
+            totalDegrees.resize(label + 1, 0.0);
+            for (size_t c = first; c < communities.size(); ++c) {
+                communities[c].cachedGraphRef = graph;
+                markCurrent(static_cast<int>(c));
+            }
+        }
+    }
+
+    // The weights of community label were updated in place for its current
+    // members and the current graph
+    void markCurrent(int label) const {
+        communities[label].cachedModificationCount = graph->getModificationCount();
+        communities[label].weightsValid = true;
+    }
+
+    void addInternal(int label, double delta) {
+        internalWeights[label] += delta;
+        internalSum += delta;
+    }
+
+    void addDegree(int label, double delta) {
+        double& total = totalDegrees[label];
+        squaredDegreeSum += (total + delta) * (total + delta) - total * total;
+        total += delta;
+    }
+
+    // Adds (sign 1) or takes out (sign -1) one edge. Community weights are
+    // stored halved, see Community::calculateWeights.
+    void applyEdge(const T& from, const T& to, double weight, double sign) {
+        double w = sign * weight;
+        m += w;
+        int a = labelOf(from);
+        int b = labelOf(to);
+        if (a >= 0) addDegree(a, w);
+        if (b >= 0) addDegree(b, w);
+        if (a >= 0 && a == b) {
+            if (!(from == to)) addInternal(a, w);
+            communities[a].internalWeight += w / 2;
+        } else {
+            if (a >= 0) communities[a].externalWeight += w / 2;
+            if (b >= 0) communities[b].externalWeight += w / 2;
+        }
+    }
+
+    void onChange(const typename Graph<T>::Change& change) {
+        using ChangeType = typename Graph<T>::ChangeType;
+        switch (change.type) {
+            case ChangeType::EdgeAdded:
+                applyEdge(change.from, change.to, change.weight, 1.0);
+                break;
+            case ChangeType::EdgeRemoved:
+                applyEdge(change.from, change.to, change.weight, -1.0);
+                break;
+            case ChangeType::VertexRemoved: {
+                // its edges were reported first, only the membership is left
+                int label = labelOf(change.from);
+                if (label >= 0) {
+                    communities[label].removeNode(change.from);
+                    markCurrent(label);
+                    labels.erase(change.from);
+                }
+                break;
+            }
+            case ChangeType::VertexAdded:
+                break;
+        }
+    }
+
+    void bind() {
+        m = graph->getTotalWeight();
+        fill(internalWeights.begin(), internalWeights.end(), 0.0);
+        fill(totalDegrees.begin(), totalDegrees.end(), 0.0);
+        for (const auto& [node, label] : labels) {
+            totalDegrees[label] += graph->getWeightedDegree(node);
+        }
+        // each internal edge once from its lower endpoint, self-loops excluded
+        for (const auto& [from, label] : labels) {
+            for (const auto& [to, weight] : graph->getNeighbors(from)) {
+                if (from < to && labelOf(to) == label) {
+                    internalWeights[label] += weight;
+                }
+            }
+        }
+        internalSum = 0.0;
+        squaredDegreeSum = 0.0;
+        for (size_t c = 0; c < communities.size(); ++c) {
+            internalSum += internalWeights[c];
+            squaredDegreeSum += totalDegrees[c] * totalDegrees[c];
+        }
+        Community<T>::calculateWeights(communities, graph);
+    }
+
+public:
+    // Binds to a graph and a disjoint partition and starts listening to the
+    // graph. Throws invalid_argument if a node is in several communities or
+    // not in the graph.
+    IncrementalCommunityMaintainer(shared_ptr<Graph<T>> graph, const vector<Community<T>>& partition)
+        : graph(graph) {
+        if (!graph) {
+            throw std::invalid_argument("Graph is null");
+        }
+        for (size_t communityId = 0; communityId < partition.size(); ++communityId) {
+            for (const auto& node : partition[communityId].getNodes()) {
+                if (!graph->hasVertex(node)) {
+                    throw std::invalid_argument("Partition contains a vertex that is not in the graph");
+                }
+                if (!labels.emplace(node, static_cast<int>(communityId)).second) {
+                    throw std::invalid_argument("Communities must be disjoint");
+                }
+            }
+        }
+        communities = partition;
+        internalWeights.resize(communities.size(), 0.0);
+        totalDegrees.resize(communities.size(), 0.0);
+        bind();
+        listenerId = graph->addChangeListener([this](const typename Graph<T>::Change& change) {
+            onChange(change);
+        });
+    }
+
+    // The graph calls back into this object, so it stays where it was made
+    IncrementalCommunityMaintainer(const IncrementalCommunityMaintainer&) = delete;
+    IncrementalCommunityMaintainer& operator=(const IncrementalCommunityMaintainer&) = delete;
+
+    ~IncrementalCommunityMaintainer() {
+        graph->removeChangeListener(listenerId);
+    }
+
+    // Rebuilds every weight from the graph, e.g. to drop rounding drift
+    // after a long stream of updates
+    void recompute() {
+        bind();
+    }
+
+    double getModularity() const {
+        if (m <= 0) {
+            return 0.0;
+        }
+        return internalSum / m - squaredDegreeSum / (4.0 * m * m);
+    }
+
+    // Moves node to targetCommunity (-1 takes it out of every community)
+    // and returns the change in modularity. Labels past getCommunityCount()
+    // open new communities. Runs in O(degree).
+    double moveNode(const T& node, int targetCommunity) {
+        if (!graph->hasVertex(node)) {
+            throw std::logic_error("Vertex does not exist");
+        }
+        int from = labelOf(node);
+        int to = targetCommunity < 0 ? -1 : targetCommunity;
+        if (from == to) {
+            return 0.0;
+        }
+        if (to >= 0) {
+            ensureCommunity(to);
+        }
+        double before = getModularity();
+
+        // a self-loop is listed twice, loop holds twice its weight
+        double toFrom = 0.0, toTarget = 0.0, loop = 0.0;
+        for (const auto& [neighbor, weight] : graph->getNeighbors(node)) {
+            if (neighbor == node) {
+                loop += weight;
+                continue;
+            }
+            int label = labelOf(neighbor);
+            if (label < 0) continue;
+            if (label == from) {
+                toFrom += weight;
+            } else if (label == to) {
+                toTarget += weight;
+            }
+        }
+        double degree = graph->getWeightedDegree(node);
+        double outward = degree - loop;  // weight of the edges to other nodes
+
+        if (from >= 0) {
+            addInternal(from, -toFrom);
+            addDegree(from, -degree);
+            communities[from].internalWeight -= toFrom / 2 + loop / 4;
+            communities[from].externalWeight += toFrom / 2 - (outward - toFrom) / 2;
+            communities[from].removeNode(node);
+            markCurrent(from);
+        }
+        if (to >= 0) {
+            addInternal(to, toTarget);
+            addDegree(to, degree);
+            communities[to].internalWeight += toTarget / 2 + loop / 4;
+            communities[to].externalWeight += (outward - toTarget) / 2 - toTarget / 2;
+            communities[to].addNode(node);
+            markCurrent(to);
+            labels[node] = to;
+        } else {
+            labels.erase(node);
+        }
+        return getModularity() - before;
+    }
+
+    // Community of node, -1 if it has none
+    int getCommunity(const T& node) const { return labelOf(node); }
+
+    // Every community by label, including communities emptied by moves. The
+    // weights of each stay current while the graph changes, so they are
+    // stamped with the graph's modification count (once per change) and a
+    // copy can be merged without recalculating them.
+    const vector<Community<T>>& getCommunities() const {
+        uint64_t modificationCount = graph->getModificationCount();
+        if (stampedModificationCount != modificationCount) {
+            for (size_t c = 0; c < communities.size(); ++c) {
+                markCurrent(static_cast<int>(c));
+            }
+            stampedModificationCount = modificationCount;
+        }
+        return communities;
+    }
+
+    size_t getCommunityCount() const { return communities.size(); }
+
+    double getInternalWeight(int community) const { return internalWeights.at(community); }
+
+    double getTotalDegree(int community) const { return totalDegrees.at(community); }
+};
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef LABELPROPAGATION_H
+#define LABELPROPAGATION_H
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <string>        // For string operations
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <algorithm>     // For sort
+#include <cstdint>       // For uint32_t
+#include <thread>        // For std::thread
+#include <mutex>         // For the color barrier
+#include <condition_variable>
+#include <atomic>        // For per-iteration change counters
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+#include "../CsrGraph/CsrGraph.h"
+using namespace std;
+
+
+// Label propagation community detection (Raghavan et al. 2007) over Graph<T>.
+//
+// Every vertex repeatedly adopts the label with the largest total edge weight
+// among its neighbors. Vertices are first greedily colored so that no two
+// neighbors share a color; each iteration then sweeps the color classes in
+// order, and all vertices of one class are updated in parallel. Vertices of
+// the same class never read each other's labels, so the result does not
+// depend on the number of threads: a multi-threaded run produces exactly the
+// partition (and modularity) of the sequential run.
+template <typename T>
+class LabelPropagationDetection {
+private:
+    unsigned numThreads = 1;
+    int maxIterations = 100;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;  // mixes the tie-breaking hash
+    int lastIterationCount = 0;
+    size_t lastColorCount = 0;
+
+    // Reusable barrier for the threads sweeping one color class at a time
+    class Barrier {
+    private:
+        mutex lock;
+        condition_variable released;
+        size_t parties;
+        size_t waiting = 0;
+        size_t generation = 0;
+
+    public:
+        explicit Barrier(size_t parties) : parties(parties) {}
+
+        void wait() {
+            unique_lock<mutex> guard(lock);
+            size_t arrivedIn = generation;
+            if (++waiting == parties) {
+                waiting = 0;
+                ++generation;
+                released.notify_all();
+            } else {
+                released.wait(guard, [&] { return generation != arrivedIn; });
+            }
+        }
+    };
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // Greedy distance-1 coloring in id order; returns the vertices grouped by
+    // color and the start of every color class in that order.
+    static void colorVertices(const CsrGraph<T>& csr, vector<uint32_t>& order, vector<size_t>& colorStart) {
+        size_t n = csr.getVertexCount();
+        vector<uint32_t> color(n, UINT32_MAX);
+        vector<uint32_t> usedBy;   // usedBy[c] == v marks color c as taken by a neighbor of v
+        uint32_t numColors = 0;
+
+        for (uint32_t v = 0; v < n; ++v) {
+            CsrNeighborRange range = csr.neighbors(v);
+            for (size_t i = 0; i < range.size(); ++i) {
+                uint32_t c = color[range.target(i)];
+                if (c != UINT32_MAX) {
+                    usedBy[c] = v;
+                }
+            }
+            uint32_t c = 0;
+            while (c < numColors && usedBy[c] == v) {
+                ++c;
+            }
+            if (c == numColors) {
+                usedBy.push_back(UINT32_MAX);
+                ++numColors;
+            }
+            color[v] = c;
+        }
+
+        colorStart.assign(numColors + 1, 0);
+        for (uint32_t v = 0; v < n; ++v) {
+            ++colorStart[color[v] + 1];
+        }
+        for (uint32_t c = 0; c < numColors; ++c) {
+            colorStart[c + 1] += colorStart[c];
+        }
+        order.resize(n);
+        vector<size_t> fill(colorStart.begin(), colorStart.end() - 1);
+        for (uint32_t v = 0; v < n; ++v) {
+            order[fill[color[v]]++] = v;
+        }
+    }
+
+    // Pick the best label for v. Ties keep the current label, otherwise they
+    // are broken by a hash of (label, vertex, iteration) so no label floods
+    // the graph just because it is numerically small.
+    uint32_t bestLabel(const CsrGraph<T>& csr, const vector<uint32_t>& labels, uint32_t v, int iteration,
+                       vector<pair<uint32_t, double>>& scratch) const {
+        CsrNeighborRange range = csr.neighbors(v);
+        scratch.clear();
+        for (size_t i = 0; i < range.size(); ++i) {
+            if (range.target(i) != v) {
+                scratch.emplace_back(labels[range.target(i)], range.weight(i));
+            }
+        }
+        uint32_t current = labels[v];
+        if (scratch.empty()) {
+            return current;
+        }
+        sort(scratch.begin(), scratch.end());
+
+        uint64_t salt = mix(seed ^ (static_cast<uint64_t>(v) << 32) ^ static_cast<uint64_t>(iteration));
+        uint32_t best = current;
+        double bestWeight = -1.0;
+        uint64_t bestHash = 0;
+        double currentWeight = 0.0;
+
+        for (size_t i = 0; i < scratch.size();) {
+            uint32_t label = scratch[i].first;
+            double weight = 0.0;
+            for (; i < scratch.size() && scratch[i].first == label; ++i) {
+                weight += scratch[i].second;
+            }
+            if (label == current) {
+                currentWeight = weight;
+            }
+            uint64_t hash = mix(salt ^ label);
+            if (weight > bestWeight || (weight == bestWeight && hash < bestHash)) {
+                best = label;
+                bestWeight = weight;
+                bestHash = hash;
+            }
+        }
+        return currentWeight >= bestWeight ? current : best;
+    }
+
+    // Sweep all color classes until no label changes; thread `tid` of
+    // `threads` updates its static slice of every class.
+    void propagate(const CsrGraph<T>& csr, const vector<uint32_t>& order, const vector<size_t>& colorStart,
+                   vector<uint32_t>& labels, vector<atomic<size_t>>& changes, Barrier* barrier,
+                   unsigned tid, unsigned threads) {
+        vector<pair<uint32_t, double>> scratch;
+        size_t numColors = colorStart.size() - 1;
+
+        for (int iteration = 0; iteration < maxIterations; ++iteration) {
+            size_t changed = 0;
+            for (size_t c = 0; c < numColors; ++c) {
+                size_t classSize = colorStart[c + 1] - colorStart[c];
+                size_t begin = colorStart[c] + classSize * tid / threads;
+                size_t end = colorStart[c] + classSize * (tid + 1) / threads;
+                for (size_t k = begin; k < end; ++k) {
+                    uint32_t v = order[k];
+                    uint32_t label = bestLabel(csr, labels, v, iteration, scratch);
+                    if (label != labels[v]) {
+                        labels[v] = label;
+                        ++changed;
+                    }
+                }
+                if (barrier) {
+                    barrier->wait();
+                }
+            }
+
+            changes[iteration].fetch_add(changed);
+            if (barrier) {
+                barrier->wait();
+            }
+            if (changes[iteration].load() == 0) {
+                if (tid == 0) {
+                    lastIterationCount = iteration + 1;
+                }
+                return;
+            }
+        }
+        if (tid == 0) {
+            lastIterationCount = maxIterations;
+        }
+    }
+
+public:
+    LabelPropagationDetection() = default;
+
+    explicit LabelPropagationDetection(unsigned numThreads) { setNumThreads(numThreads); }
+
+    // 0 uses every hardware thread
+    void setNumThreads(unsigned threads) {
+        numThreads = threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
+    }
+
+    unsigned getNumThreads() const { return numThreads; }
+
+    void setMaxIterations(int iterations) { maxIterations = iterations; }
+
+    void setSeed(uint64_t newSeed) { seed = newSeed; }
+
+    int getLastIterationCount() const { return lastIterationCount; }
+
+    size_t getLastColorCount() const { return lastColorCount; }
+
+    vector<Community<T>> detectCommunitiesFromGraph(shared_ptr<Graph<T>> g) {
+        if (!g) {
+            throw std::invalid_argument("Graph is null");
+        }
+        return detectCommunitiesFromCsr(g->freeze());
+    }
+
+    vector<Community<T>> detectCommunitiesFromCsr(const CsrGraph<T>& csr) {
+        size_t n = csr.getVertexCount();
+        lastIterationCount = 0;
+
+        vector<uint32_t> order;
+        vector<size_t> colorStart;
+        colorVertices(csr, order, colorStart);
+        lastColorCount = colorStart.size() - 1;
+
+        vector<uint32_t> labels(n);
+        for (uint32_t v = 0; v < n; ++v) {
+            labels[v] = v;
+        }
+        vector<atomic<size_t>> changes(max(maxIterations, 1));
+        for (auto& counter : changes) {
+            counter.store(0);
+        }
+
+        unsigned threads = static_cast<unsigned>(min<size_t>(numThreads, max<size_t>(n, 1)));
+        if (threads <= 1) {
+            propagate(csr, order, colorStart, labels, changes, nullptr, 0, 1);
+        } else {
+            Barrier barrier(threads);
+            vector<thread> workers;
+            for (unsigned tid = 0; tid < threads; ++tid) {
+                workers.emplace_back([&, tid] {
+                    propagate(csr, order, colorStart, labels, changes, &barrier, tid, threads);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        // one community per label, in order of first appearance
+        vector<uint32_t> communityOf(n, UINT32_MAX);
+        vector<Community<T>> communities;
+        for (uint32_t v = 0; v < n; ++v) {
+            uint32_t& slot = communityOf[labels[v]];
+            if (slot == UINT32_MAX) {
+                slot = static_cast<uint32_t>(communities.size());
+                communities.emplace_back();
+            }
+            communities[slot].addNode(csr.getVertex(v));
+        }
+        return communities;
+    }
+};
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef LFRGENERATOR_H
+#define LFRGENERATOR_H
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <string>        // For to_string
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <algorithm>     // For sort, unique
+#include <cmath>         // For pow, log, floor
+#include <cstdint>       // For uint32_t, uint64_t
+#include <random>        // For mt19937_64
+#include <type_traits>   // For is_same
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+using namespace std;
+
+
+// Parameters of an LFR benchmark network (Lancichinetti, Fortunato and
+// Radicchi 2008). Community sizes of 0 are derived from the degree range.
+struct LfrParameters {
+    uint32_t numNodes = 1000;
+    double averageDegree = 20;
+    uint32_t maxDegree = 50;
+    double degreeExponent = 2;      // tau1, degrees follow k^-tau1
+    double communityExponent = 1;   // tau2, community sizes follow s^-tau2
+    double mixing = 0.1;            // mu, fraction of each node's edges leaving its community
+    uint32_t minCommunity = 0;      // 0: the smallest degree
+    uint32_t maxCommunity = 0;      // 0: maxDegree
+    uint64_t seed = 1;
+};
+
+
+// Undirected, unweighted LFR benchmark graph with its ground truth partition,
+// generated in memory.
+//
+// Degrees and community sizes are drawn from truncated power laws. Every
+// node gets round((1 - mu) k) internal stubs and is placed, in decreasing
+// order of internal degree, in a random community large enough to hold them.
+// Internal stubs are then paired within each community and external stubs
+// across communities, configuration-model style; pairs that would form a
+// self-loop, a repeated edge or (for external stubs) an internal edge are
+// reshuffled and paired again a few times, and stubs that still cannot be
+// paired are dropped. All randomness comes from one mt19937_64 stream and
+// none of the implementation-defined std distributions, so a seed gives the
+// same network with every standard library.
+template <typename T>
+class LfrGenerator {
+private:
+    LfrParameters params;
+    mt19937_64 rng;
+    vector<uint32_t> membership;       // community of every node
+    vector<uint32_t> communitySizes;   // sorted by decreasing size
+    vector<pair<uint32_t, uint32_t>> edges;
+    size_t internalEdgeCount = 0;
+
+    // Rounds with reshuffling before unpaired stubs are dropped
+    static constexpr int pairingRounds = 8;
+
+    double uniform() {
+        return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Uniform integer in [0, bound), bound below 2^32
+    uint64_t uniformIndex(uint64_t bound) {
+        return static_cast<uint64_t>(uniform() * static_cast<double>(bound));
+    }
+
+    template <typename Item>
+    void shuffle(vector<Item>& items) {
+        for (size_t i = items.size(); i > 1; --i) {
+            swap(items[i - 1], items[uniformIndex(i)]);
+        }
+    }
+
+    // Sample of a continuous power law x^-exponent on [low, high)
+    double powerLaw(double low, double high, double exponent) {
+        double u = uniform();
+        if (fabs(exponent - 1) < 1e-12) {
+            return low * pow(high / low, u);
+        }
+        double a = pow(low, 1 - exponent), b = pow(high, 1 - exponent);
+        return pow(a + (b - a) * u, 1 / (1 - exponent));
+    }
+
+    // Mean of a continuous power law x^-exponent on [low, high)
+    static double powerLawMean(double low, double high, double exponent) {
+        if (fabs(exponent - 1) < 1e-12) {
+            return (high - low) / log(high / low);
+        }
+        if (fabs(exponent - 2) < 1e-12) {
+            return log(high / low) / (1 / low - 1 / high);
+        }
+        return (1 - exponent) / (2 - exponent) * (pow(high, 2 - exponent) - pow(low, 2 - exponent))
+             / (pow(high, 1 - exponent) - pow(low, 1 - exponent));
+    }
+
+    /**
+     * Smallest degree (real valued) for which floor of the power law on
+     * [minDegree, maxDegree + 1) has the requested mean, by bisection
+     */
+    double solveMinDegree() const {
+        double high = params.maxDegree + 1.0;
+        double target = params.averageDegree + 0.5;  // floor takes 1/2 off on average
+        double low = 1, top = params.maxDegree;
+        if (powerLawMean(low, high, params.degreeExponent) > target ||
+            powerLawMean(top, high, params.degreeExponent) < target) {
+            throw invalid_argument("Average degree cannot be reached with this maximum degree and exponent");
+        }
+        for (int i = 0; i < 100; ++i) {
+            double mid = (low + top) / 2;
+            (powerLawMean(mid, high, params.degreeExponent) < target ? low : top) = mid;
+        }
+        return (low + top) / 2;
+    }
+
+    void drawCommunitySizes(uint32_t minSize, uint32_t maxSize) {
+        uint64_t total = 0;
+        while (total < params.numNodes) {
+            auto size = static_cast<uint32_t>(powerLaw(minSize, maxSize + 1.0, params.communityExponent));
+            size = min(max(size, minSize), maxSize);
+            communitySizes.push_back(size);
+            total += size;
+        }
+        // The last community overshoots: shrink it to the nodes left, and
+        // spread those over the others if that would make it too small
+        total -= communitySizes.back();
+        uint32_t left = static_cast<uint32_t>(params.numNodes - total);
+        communitySizes.pop_back();
+        if (left >= minSize || communitySizes.empty()) {
+            communitySizes.push_back(left);
+        } else {
+            for (size_t c = 0; left > 0; c = (c + 1) % communitySizes.size()) {
+                if (communitySizes[c] < maxSize || all_of(communitySizes.begin(), communitySizes.end(),
+                                                          [&](uint32_t s) { return s >= maxSize; })) {
+                    ++communitySizes[c];
+                    --left;
+                }
+            }
+        }
+        sort(communitySizes.rbegin(), communitySizes.rend());
+    }
+
+    /**
+     * Places nodes by decreasing internal degree into a random community with
+     * room left among those larger than that degree. If they are all full
+     * the node goes to the largest community with room, and its internal
+     * degree is cut to fit.
+     */
+    void assignCommunities(vector<uint32_t>& internalDegree) {
+        uint32_t n = params.numNodes;
+        vector<uint32_t> order(n);
+        uint32_t maxInternal = 0;
+        for (uint32_t v = 0; v < n; ++v) maxInternal = max(maxInternal, internalDegree[v]);
+        // counting sort by decreasing internal degree
+        vector<uint32_t> start(maxInternal + 2, 0);
+        for (uint32_t v = 0; v < n; ++v) ++start[maxInternal - internalDegree[v] + 1];
+        for (size_t d = 1; d < start.size(); ++d) start[d] += start[d - 1];
+        for (uint32_t v = 0; v < n; ++v) order[start[maxInternal - internalDegree[v]]++] = v;
+
+        vector<uint32_t> room(communitySizes);
+        vector<uint32_t> open;   // eligible communities with room
+        size_t eligible = 0;     // communities [0, eligible) are larger than the current degree
+        size_t fallback = 0;     // first community that may still have room
+        membership.assign(n, 0);
+        for (uint32_t v : order) {
+            while (eligible < communitySizes.size() && communitySizes[eligible] > internalDegree[v]) {
+                if (room[eligible] > 0) open.push_back(static_cast<uint32_t>(eligible));
+                ++eligible;
+            }
+            uint32_t community;
+            if (!open.empty()) {
+                size_t pick = uniformIndex(open.size());
+                community = open[pick];
+                if (--room[community] == 0) {
+                    open[pick] = open.back();
+                    open.pop_back();
+                }
+            } else {
+                while (room[fallback] == 0) ++fallback;
+                community = static_cast<uint32_t>(fallback);
+                --room[community];
+                internalDegree[v] = min(internalDegree[v], communitySizes[community] - 1);
+            }
+            membership[v] = community;
+        }
+    }
+
+    /**
+     * Pairs stubs at random into edges and appends them. Pairs rejected by
+     * valid() or repeating an edge are reshuffled and paired again.
+     * @return Number of edges added
+     */
+    template <typename Valid>
+    size_t pairStubs(vector<uint32_t>& stubs, Valid valid) {
+        vector<uint64_t> accepted;
+        vector<uint64_t> round;
+        vector<uint32_t> leftover;
+        for (int attempt = 0; attempt < pairingRounds && stubs.size() >= 2; ++attempt) {
+            shuffle(stubs);
+            round.clear();
+            leftover.clear();
+            for (size_t i = 0; i + 1 < stubs.size(); i += 2) {
+                uint32_t a = min(stubs[i], stubs[i + 1]), b = max(stubs[i], stubs[i + 1]);
+                if (a != b && valid(a, b)) {
+                    round.push_back(static_cast<uint64_t>(a) << 32 | b);
+                } else {
+                    leftover.push_back(a);
+                    leftover.push_back(b);
+                }
+            }
+            sort(round.begin(), round.end());
+            size_t before = accepted.size();
+            for (size_t i = 0; i < round.size(); ++i) {
+                bool repeated = (i > 0 && round[i] == round[i - 1]) ||
+                                binary_search(accepted.begin(), accepted.begin() + before, round[i]);
+                if (repeated) {
+                    leftover.push_back(static_cast<uint32_t>(round[i] >> 32));
+                    leftover.push_back(static_cast<uint32_t>(round[i]));
+                } else {
+                    accepted.push_back(round[i]);
+                }
+            }
+            inplace_merge(accepted.begin(), accepted.begin() + before, accepted.end());
+            if (leftover.size() == stubs.size()) {
+                break;  // no progress, the remaining stubs cannot be paired
+            }
+            stubs.swap(leftover);
+        }
+        for (uint64_t key : accepted) {
+            edges.emplace_back(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key));
+        }
+        return accepted.size();
+    }
+
+    void generate() {
+        uint32_t n = params.numNodes;
+        double minDegree = solveMinDegree();
+        uint32_t minCommunity = params.minCommunity ? params.minCommunity : static_cast<uint32_t>(ceil(minDegree));
+        uint32_t maxCommunity = params.maxCommunity ? params.maxCommunity : params.maxDegree;
+        maxCommunity = min(maxCommunity, n);
+        if (minCommunity > maxCommunity) {
+            throw invalid_argument("Minimum community size exceeds the maximum");
+        }
+
+        vector<uint32_t> degree(n), internalDegree(n);
+        for (uint32_t v = 0; v < n; ++v) {
+            degree[v] = static_cast<uint32_t>(powerLaw(minDegree, params.maxDegree + 1.0, params.degreeExponent));
+            degree[v] = min(degree[v], params.maxDegree);
+            // randomized rounding keeps the mixing exact on average
+            internalDegree[v] = static_cast<uint32_t>(floor((1 - params.mixing) * degree[v] + uniform()));
+            internalDegree[v] = min(internalDegree[v], degree[v]);
+        }
+        drawCommunitySizes(minCommunity, maxCommunity);
+        assignCommunities(internalDegree);
+
+        // Members of each community, and an even number of internal stubs in
+        // each (one stub of an odd community becomes external)
+        vector<uint32_t> offset(communitySizes.size() + 1, 0);
+        for (uint32_t v = 0; v < n; ++v) ++offset[membership[v] + 1];
+        for (size_t c = 0; c < communitySizes.size(); ++c) offset[c + 1] += offset[c];
+        vector<uint32_t> members(n);
+        vector<uint32_t> fill(offset.begin(), offset.end() - 1);
+        for (uint32_t v = 0; v < n; ++v) members[fill[membership[v]]++] = v;
+
+        uint64_t totalStubs = 0;
+        for (uint32_t v = 0; v < n; ++v) totalStubs += degree[v];
+        edges.reserve(totalStubs / 2);
+
+        vector<uint32_t> stubs;
+        for (size_t c = 0; c < communitySizes.size(); ++c) {
+            stubs.clear();
+            uint32_t* first = members.data() + offset[c];
+            uint32_t* last = members.data() + offset[c + 1];
+            uint64_t sum = 0;
+            for (uint32_t* v = first; v != last; ++v) sum += internalDegree[*v];
+            if (sum % 2 == 1) {
+                for (uint32_t* v = first; v != last; ++v) {
+                    if (internalDegree[*v] > 0) {
+                        --internalDegree[*v];
+                        break;
+                    }
+                }
+            }
+            for (uint32_t* v = first; v != last; ++v) {
+                stubs.insert(stubs.end(), internalDegree[*v], *v);
+            }
+            internalEdgeCount += pairStubs(stubs, [](uint32_t, uint32_t) { return true; });
+        }
+
+        stubs.clear();
+        for (uint32_t v = 0; v < n; ++v) {
+            stubs.insert(stubs.end(), degree[v] - internalDegree[v], v);
+        }
+        pairStubs(stubs, [&](uint32_t a, uint32_t b) { return membership[a] != membership[b]; });
+    }
+
+    static T makeVertex(uint32_t id) {
+        if constexpr (is_same<T, string>::value) {
+            return to_string(id);
+        } else {
+            return static_cast<T>(id);
+        }
+    }
+
+public:
+    /**
+     * Generates the network; the same parameters and seed always give the
+     * same network
+     */
+    explicit LfrGenerator(const LfrParameters& parameters) : params(parameters), rng(parameters.seed) {
+        if (params.numNodes == 0) {
+            throw invalid_argument("LFR network needs at least one node");
+        }
+        if (params.mixing < 0 || params.mixing > 1) {
+            throw invalid_argument("Mixing parameter must be in [0, 1]");
+        }
+        if (params.maxDegree == 0 || params.maxDegree >= params.numNodes) {
+            throw invalid_argument("Maximum degree must be in [1, numNodes)");
+        }
+        if (params.degreeExponent <= 0 || params.communityExponent <= 0) {
+            throw invalid_argument("Power-law exponents must be positive");
+        }
+        generate();
+    }
+
+    // Node v is vertex makeVertex(v), i.e. v or to_string(v)
+    const vector<pair<uint32_t, uint32_t>>& getEdges() const { return edges; }
+
+    // Ground truth community of every node, communities ordered by decreasing size
+    const vector<uint32_t>& getMembership() const { return membership; }
+
+    size_t getCommunityCount() const { return communitySizes.size(); }
+
+    // Fraction of the edges that join two communities
+    double measuredMixing() const {
+        return edges.empty() ? 0 : 1 - static_cast<double>(internalEdgeCount) / edges.size();
+    }
+
+    /**
+     * Builds the Graph<T> in one bulk step, unit weights
+     * @return Graph over vertices 0 .. numNodes - 1
+     */
+    shared_ptr<Graph<T>> buildGraph() const {
+        vector<T> vertices;
+        vertices.reserve(params.numNodes);
+        for (uint32_t v = 0; v < params.numNodes; ++v) {
+            vertices.push_back(makeVertex(v));
+        }
+        vector<typename Graph<T>::BulkEdge> bulk;
+        bulk.reserve(edges.size());
+        for (const auto& [a, b] : edges) {
+            bulk.push_back({a, b, 1.0});
+        }
+        return make_shared<Graph<T>>(Graph<T>::buildBulk(vertices, bulk));
+    }
+
+    /**
+     * Ground truth communities, in the order of getMembership()
+     * @return One community per label
+     */
+    vector<Community<T>> buildCommunities() const {
+        vector<vector<T>> nodesOf(communitySizes.size());
+        for (uint32_t v = 0; v < params.numNodes; ++v) {
+            nodesOf[membership[v]].push_back(makeVertex(v));
+        }
+        vector<Community<T>> communities(communitySizes.size());
+        for (size_t c = 0; c < communities.size(); ++c) {
+            sort(nodesOf[c].begin(), nodesOf[c].end());
+            communities[c].addNodes(nodesOf[c].begin(), nodesOf[c].end());
+        }
+        return communities;
+    }
+};
+
+#endif
@@ -0,0 +1,333 @@
+#ifndef LOUVAINDETECTION_H
+#define LOUVAINDETECTION_H
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <fstream>       // For file I/O
+#include <string>        // For string operations
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <algorithm>     // For shuffle
+#include <numeric>       // For iota
+#include <random>        // For mt19937
+#include <cstdint>       // For uint32_t
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+#include "../CsrGraph/CsrGraph.h"
+using namespace std;
+
+
+// Native Louvain community detection (Blondel et al. 2008) over Graph<T>.
+//
+// The graph is frozen into a CsrGraph once; every level then runs the local
+// moving phase on dense ids, scoring each candidate move with the usual
+// incremental modularity gain
+//      dQ = [ k_i,c - k_i,old - k_i * (tot_c - tot_old) / 2m ] / m
+// (k_i,c = weight from i into c, tot_c = total degree of c without i),
+// and aggregates each community into one node of the next, coarser level.
+// Nothing ever recomputes modularity from scratch.
+template <typename T>
+class LouvainDetection {
+private:
+    shared_ptr<Graph<T>> graph;
+    double minModularityGain = 1e-7;  // stop a level when a full pass gains less than this
+    int maxLevels = -1;               // -1 = aggregate until nothing moves
+    unsigned seed = 0;                // 0 = visit nodes in id order, otherwise shuffle with this seed
+    double lastModularity = 0.0;
+    int lastLevelCount = 0;
+
+    // One level of the hierarchy. Self-loops (the internal weight of the
+    // communities aggregated into a node) are kept apart from the adjacency.
+    struct LevelGraph {
+        vector<uint64_t> offsets;
+        vector<uint32_t> targets;
+        vector<double> weights;
+        vector<double> selfLoops;  // internal edge weight, each edge counted once
+        vector<double> degrees;    // sum of adjacent weights + 2 * selfLoop
+
+        size_t size() const { return degrees.size(); }
+    };
+
+    static LevelGraph levelFromCsr(const CsrGraph<T>& csr) {
+        LevelGraph level;
+        size_t n = csr.getVertexCount();
+        level.offsets.assign(n + 1, 0);
+        level.targets.reserve(csr.getEntryCount());
+        level.weights.reserve(csr.getEntryCount());
+        level.selfLoops.assign(n, 0.0);
+        level.degrees.resize(n);
+
+        for (uint32_t id = 0; id < n; ++id) {
+            CsrNeighborRange range = csr.neighbors(id);
+            for (size_t i = 0; i < range.size(); ++i) {
+                if (range.target(i) == id) {
+                    // Graph2 lists a self-loop twice in its own adjacency
+                    level.selfLoops[id] += range.weight(i) / 2;
+                } else {
+                    level.targets.push_back(range.target(i));
+                    level.weights.push_back(range.weight(i));
+                }
+            }
+            level.offsets[id + 1] = level.targets.size();
+            level.degrees[id] = csr.getWeightedDegree(id);
+        }
+        return level;
+    }
+
+    // Local moving phase. Returns true if any node changed community.
+    bool moveNodes(const LevelGraph& level, double m, vector<uint32_t>& community, mt19937& rng) const {
+        size_t n = level.size();
+        double m2 = 2.0 * m;
+
+        vector<double> tot(level.degrees);          // every node starts alone
+        vector<double> weightTo(n, 0.0);            // k_i,c accumulator, indexed by community
+        vector<uint32_t> touched;                   // communities with weightTo set
+        vector<char> isTouched(n, 0);
+
+        vector<uint32_t> order(n);
+        iota(order.begin(), order.end(), 0);
+        if (seed != 0) {
+            shuffle(order.begin(), order.end(), rng);
+        }
+
+        bool movedAny = false;
+        while (true) {
+            double passGain = 0.0;
+            size_t moves = 0;
+
+            for (uint32_t node : order) {
+                uint32_t current = community[node];
+                double k = level.degrees[node];
+
+                // weight from node into each neighboring community
+                touched.clear();
+                for (uint64_t e = level.offsets[node]; e < level.offsets[node + 1]; ++e) {
+                    uint32_t c = community[level.targets[e]];
+                    if (!isTouched[c]) {
+                        isTouched[c] = 1;
+                        touched.push_back(c);
+                    }
+                    weightTo[c] += level.weights[e];
+                }
+
+                // take the node out of its community
+                tot[current] -= k;
+                double weightToCurrent = weightTo[current];
+
+                uint32_t best = current;
+                double bestGain = weightToCurrent - tot[current] * k / m2;
+                for (uint32_t c : touched) {
+                    double gain = weightTo[c] - tot[c] * k / m2;
+                    if (gain > bestGain) {
+                        bestGain = gain;
+                        best = c;
+                    }
+                }
+
+                tot[best] += k;
+                if (best != current) {
+                    community[node] = best;
+                    passGain += (weightTo[best] - weightToCurrent
+                                 - k * (tot[best] - k - tot[current]) / m2) / m;
+                    ++moves;
+                }
+
+                for (uint32_t c : touched) {
+                    weightTo[c] = 0.0;
+                    isTouched[c] = 0;
+                }
+            }
+
+            if (moves > 0) {
+                movedAny = true;
+            }
+            if (moves == 0 || passGain < minModularityGain) {
+                break;
+            }
+        }
+        return movedAny;
+    }
+
+    // Renumber communities densely (in order of first appearance) and return their count
+    static uint32_t renumber(vector<uint32_t>& community) {
+        vector<uint32_t> newId(community.size(), UINT32_MAX);
+        uint32_t next = 0;
+        for (uint32_t& c : community) {
+            if (newId[c] == UINT32_MAX) {
+                newId[c] = next++;
+            }
+            c = newId[c];
+        }
+        return next;
+    }
+
+    // Collapse every community of level into one node of the returned level
+    static LevelGraph aggregate(const LevelGraph& level, const vector<uint32_t>& community, uint32_t numCommunities) {
+        size_t n = level.size();
+
+        // bucket nodes by community (counting sort)
+        vector<uint32_t> start(numCommunities + 1, 0);
+        for (uint32_t c : community) {
+            ++start[c + 1];
+        }
+        for (uint32_t c = 0; c < numCommunities; ++c) {
+            start[c + 1] += start[c];
+        }
+        vector<uint32_t> members(n);
+        vector<uint32_t> fill(start.begin(), start.end() - 1);
+        for (uint32_t node = 0; node < n; ++node) {
+            members[fill[community[node]]++] = node;
+        }
+
+        LevelGraph coarse;
+        coarse.offsets.assign(numCommunities + 1, 0);
+        coarse.selfLoops.assign(numCommunities, 0.0);
+        coarse.degrees.assign(numCommunities, 0.0);
+
+        vector<double> weightTo(numCommunities, 0.0);
+        vector<uint32_t> touched;
+        vector<char> isTouched(numCommunities, 0);
+
+        for (uint32_t c = 0; c < numCommunities; ++c) {
+            touched.clear();
+            for (uint32_t k = start[c]; k < start[c + 1]; ++k) {
+                uint32_t node = members[k];
+                coarse.selfLoops[c] += level.selfLoops[node];
+                coarse.degrees[c] += level.degrees[node];
+                for (uint64_t e = level.offsets[node]; e < level.offsets[node + 1]; ++e) {
+                    uint32_t other = community[level.targets[e]];
+                    if (other == c) {
+                        // internal edges are seen from both endpoints
+                        coarse.selfLoops[c] += level.weights[e] / 2;
+                    } else {
+                        if (!isTouched[other]) {
+                            isTouched[other] = 1;
+                            touched.push_back(other);
+                        }
+                        weightTo[other] += level.weights[e];
+                    }
+                }
+            }
+
+            sort(touched.begin(), touched.end());
+            for (uint32_t other : touched) {
+                coarse.targets.push_back(other);
+                coarse.weights.push_back(weightTo[other]);
+                weightTo[other] = 0.0;
+                isTouched[other] = 0;
+            }
+            coarse.offsets[c + 1] = coarse.targets.size();
+        }
+        return coarse;
+    }
+
+    // Q = sum_c [ in_c / m - (tot_c / 2m)^2 ] with every node of level being one community
+    static double levelModularity(const LevelGraph& level, double m) {
+        double q = 0.0;
+        for (size_t c = 0; c < level.size(); ++c) {
+            q += level.selfLoops[c] / m - (level.degrees[c] / (2.0 * m)) * (level.degrees[c] / (2.0 * m));
+        }
+        return q;
+    }
+
+public:
+    LouvainDetection() = default;
+
+    LouvainDetection(shared_ptr<Graph<T>> g) : graph(g) {}
+
+    void setMinModularityGain(double gain) { minModularityGain = gain; }
+
+    void setMaxLevels(int levels) { maxLevels = levels; }
+
+    // 0 keeps the deterministic id order; any other value shuffles the visit order
+    void setSeed(unsigned newSeed) { seed = newSeed; }
+
+    // Modularity of the partition returned by the last detection
+    double getLastModularity() const { return lastModularity; }
+
+    // Number of aggregation levels the last detection went through
+    int getLastLevelCount() const { return lastLevelCount; }
+
+    // Load a graph in the Graph2 text format and detect its communities
+    vector<Community<T>> detectCommunities(const string& edgeListFile) {
+        graph = make_shared<Graph<T>>(Graph<T>::loadBulk(edgeListFile));
+        return detectCommunitiesFromGraph(graph);
+    }
+
+    vector<Community<T>> detectCommunitiesFromGraph(shared_ptr<Graph<T>> g) {
+        if (!g) {
+            throw std::invalid_argument("Graph is null");
+        }
+        graph = g;
+        return detectCommunitiesFromCsr(graph->freeze());
+    }
+
+    // Works on any CSR snapshot, including memory mapped ones (CsrGraph::loadBinary)
+    vector<Community<T>> detectCommunitiesFromCsr(const CsrGraph<T>& csr) {
+        size_t n = csr.getVertexCount();
+        double m = csr.getTotalWeight();
+        lastModularity = 0.0;
+        lastLevelCount = 0;
+
+        // finalCommunity[id] is the community of original vertex id at the current level
+        vector<uint32_t> finalCommunity(n);
+        iota(finalCommunity.begin(), finalCommunity.end(), 0);
+
+        if (m > 0) {
+            mt19937 rng(seed);
+            LevelGraph level = levelFromCsr(csr);
+
+            while (maxLevels < 0 || lastLevelCount < maxLevels) {
+                vector<uint32_t> community(level.size());
+                iota(community.begin(), community.end(), 0);
+
+                bool moved = moveNodes(level, m, community, rng);
+                if (!moved) {
+                    break;
+                }
+
+                uint32_t numCommunities = renumber(community);
+                for (uint32_t& c : finalCommunity) {
+                    c = community[c];
+                }
+                level = aggregate(level, community, numCommunities);
+                ++lastLevelCount;
+            }
+            lastModularity = levelModularity(level, m);
+        }
+
+        // isolated vertices and edgeless graphs end up as singletons
+        uint32_t numCommunities = renumber(finalCommunity);
+        vector<Community<T>> communities(numCommunities);
+        for (uint32_t id = 0; id < n; ++id) {
+            communities[finalCommunity[id]].addNode(csr.getVertex(id));
+        }
+        return communities;
+    }
+
+    // Write "node community" lines, the format read by CommunityComparison::loadCommunities
+    void writeCommunities(const vector<Community<T>>& communities, const string& outputFile) {
+        ofstream file(outputFile);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + outputFile);
+        }
+        for (size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for (const auto& node : communities[communityId].getNodes()) {
+                file << node << " " << communityId << "\n";
+            }
+        }
+    }
+
+    // Detect communities for every input graph file and write them to the matching output file
+    void batchProcess(const vector<string>& inputFiles, const vector<string>& outputFiles) {
+        if (inputFiles.size() != outputFiles.size()) {
+            throw std::invalid_argument("Number of input and output files must match");
+        }
+        for (size_t i = 0; i < inputFiles.size(); ++i) {
+            writeCommunities(detectCommunities(inputFiles[i]), outputFiles[i]);
+        }
+    }
+};
+
+#endif
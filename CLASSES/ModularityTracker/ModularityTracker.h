@@ -0,0 +1,244 @@
+#ifndef MODULARITYTRACKER_H
+#define MODULARITYTRACKER_H
+
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <cmath>         // For pow
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+using namespace std;
+
+
+// Modularity of a disjoint partition of a Graph<T> that is kept up to date
+// while single nodes move between communities.
+//
+// The tracker stores L_c (internal edge weight, self-loops excluded) and K_c
+// (sum of weighted degrees) for every community label, so the modularity
+// change of moving one node only needs that node's neighbor list:
+// deltaMove and applyMove run in O(degree). Scores match
+// Graph<T>::calculateModularity for the same partition. Nodes without a
+// community carry the label -1 and contribute nothing, just like nodes
+// missing from the label map given to calculateModularity.
+//
+// The graph must not change while a tracker is bound to it.
+template <typename T>
+class ModularityTracker {
+private:
+    shared_ptr<Graph<T>> graph;
+    unordered_map<T, int> labels;       // node -> community label (-1 = none)
+    vector<double> internalWeights;     // L_c
+    vector<double> totalDegrees;        // K_c
+    vector<size_t> communitySizes;
+    double m = 0.0;
+    double modularity = 0.0;
+
+    int labelOf(const T& node) const {
+        auto it = labels.find(node);
+        if (it == labels.end()) {
+            throw std::logic_error("Vertex does not exist");
+        }
+        return it->second;
+    }
+
+    void ensureLabel(int label) {
+        if (label >= static_cast<int>(internalWeights.size())) {
+            internalWeights.resize(label + 1, 0.0);
+            totalDegrees.resize(label + 1, 0.0);
+            communitySizes.resize(label + 1, 0);
+        }
+    }
+
+    // Contribution of one community to Q
+    double score(double internal, double total) const {
+        return internal / m - pow(total / (2.0 * m), 2);
+    }
+
+    // Edge weight between node and the communities `from` and `to`
+    void linkWeights(const T& node, int from, int to, double& toFrom, double& toTarget) const {
+        toFrom = 0.0;
+        toTarget = 0.0;
+        for (const auto& [neighbor, weight] : graph->getNeighbors(node)) {
+            if (neighbor == node) continue;
+            int label = labels.at(neighbor);
+            if (label < 0) continue;
+            if (label == from) {
+                toFrom += weight;
+            } else if (label == to) {
+                toTarget += weight;
+            }
+        }
+    }
+
+    // Modularity change of moving a node with the given weighted degree and
+    // link weights from community `from` to community `to`
+    double moveDelta(int from, int to, double toFrom, double toTarget, double degree) const {
+        double delta = 0.0;
+        if (from >= 0) {
+            delta += score(internalWeights[from] - toFrom, totalDegrees[from] - degree)
+                   - score(internalWeights[from], totalDegrees[from]);
+        }
+        if (to >= 0) {
+            double internal = to < static_cast<int>(internalWeights.size()) ? internalWeights[to] : 0.0;
+            double total = to < static_cast<int>(totalDegrees.size()) ? totalDegrees[to] : 0.0;
+            delta += score(internal + toTarget, total + degree) - score(internal, total);
+        }
+        return delta;
+    }
+
+    void bind(const unordered_map<T, int>& nodeToCommunity) {
+        m = graph->getTotalWeight();
+        fill(internalWeights.begin(), internalWeights.end(), 0.0);
+        fill(totalDegrees.begin(), totalDegrees.end(), 0.0);
+        fill(communitySizes.begin(), communitySizes.end(), 0);
+
+        labels.clear();
+        labels.reserve(graph->getVertexCount());
+        for (const auto& vertex : graph->getVertices()) {
+            labels.emplace(vertex, -1);
+        }
+        for (const auto& [node, label] : nodeToCommunity) {
+            auto it = labels.find(node);
+            if (it == labels.end()) {
+                throw std::invalid_argument("Partition contains a vertex that is not in the graph");
+            }
+            if (label < 0) continue;
+            it->second = label;
+            ensureLabel(label);
+            totalDegrees[label] += graph->getWeightedDegree(node);
+            ++communitySizes[label];
+        }
+
+        // each internal edge once from its lower endpoint, self-loops excluded
+        for (const auto& [from, label] : labels) {
+            if (label < 0) continue;
+            for (const auto& [to, weight] : graph->getNeighbors(from)) {
+                if (from < to && labels.at(to) == label) {
+                    internalWeights[label] += weight;
+                }
+            }
+        }
+
+        modularity = 0.0;
+        if (m > 0) {
+            for (size_t c = 0; c < internalWeights.size(); ++c) {
+                modularity += score(internalWeights[c], totalDegrees[c]);
+            }
+        }
+    }
+
+public:
+    // Binds to a graph and a disjoint partition. Throws invalid_argument if a
+    // node is in several communities or not in the graph.
+    ModularityTracker(shared_ptr<Graph<T>> graph, const vector<Community<T>>& communities) : graph(graph) {
+        if (!graph) {
+            throw std::invalid_argument("Graph is null");
+        }
+        unordered_map<T, int> nodeToCommunity;
+        for (size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for (const auto& node : communities[communityId].getNodes()) {
+                if (!nodeToCommunity.emplace(node, static_cast<int>(communityId)).second) {
+                    throw std::invalid_argument("Communities must be disjoint");
+                }
+            }
+        }
+        ensureLabel(static_cast<int>(communities.size()) - 1);
+        bind(nodeToCommunity);
+    }
+
+    // Binds to a graph and a node -> community label map (negative labels
+    // and missing nodes belong to no community)
+    ModularityTracker(shared_ptr<Graph<T>> graph, const unordered_map<T, int>& nodeToCommunity) : graph(graph) {
+        if (!graph) {
+            throw std::invalid_argument("Graph is null");
+        }
+        bind(nodeToCommunity);
+    }
+
+    // Rebuilds L_c, K_c and Q from scratch, e.g. to drop rounding drift
+    // after a long sequence of moves
+    void recompute() {
+        unordered_map<T, int> current;
+        current.swap(labels);
+        bind(current);
+    }
+
+    // Change in modularity if node moved to targetCommunity (-1 removes it
+    // from its community). The partition is not modified.
+    double deltaMove(const T& node, int targetCommunity) const {
+        int from = labelOf(node);
+        int to = targetCommunity < 0 ? -1 : targetCommunity;
+        if (from == to || m <= 0) {
+            return 0.0;
+        }
+
+        double toFrom, toTarget;
+        linkWeights(node, from, to, toFrom, toTarget);
+        return moveDelta(from, to, toFrom, toTarget, graph->getWeightedDegree(node));
+    }
+
+    // Moves node to targetCommunity and returns the change in modularity.
+    // Labels past getCommunityCount() open new communities.
+    double applyMove(const T& node, int targetCommunity) {
+        int from = labelOf(node);
+        int to = targetCommunity < 0 ? -1 : targetCommunity;
+        if (from == to) {
+            return 0.0;
+        }
+        double toFrom, toTarget;
+        linkWeights(node, from, to, toFrom, toTarget);
+        double degree = graph->getWeightedDegree(node);
+        double delta = m > 0 ? moveDelta(from, to, toFrom, toTarget, degree) : 0.0;
+
+        if (from >= 0) {
+            internalWeights[from] -= toFrom;
+            totalDegrees[from] -= degree;
+            --communitySizes[from];
+        }
+        if (to >= 0) {
+            ensureLabel(to);
+            internalWeights[to] += toTarget;
+            totalDegrees[to] += degree;
+            ++communitySizes[to];
+        }
+        labels[node] = to;
+        modularity += delta;
+        return delta;
+    }
+
+    double getModularity() const { return modularity; }
+
+    int getCommunity(const T& node) const { return labelOf(node); }
+
+    // Number of community labels in use, including communities emptied by moves
+    size_t getCommunityCount() const { return internalWeights.size(); }
+
+    size_t getCommunitySize(int community) const { return communitySizes.at(community); }
+
+    double getInternalWeight(int community) const { return internalWeights.at(community); }
+
+    double getTotalDegree(int community) const { return totalDegrees.at(community); }
+
+    const unordered_map<T, int>& getLabels() const { return labels; }
+
+    // Current partition, one Community per non-empty label in label order
+    vector<Community<T>> getCommunities() const {
+        vector<int> slot(internalWeights.size(), -1);
+        vector<Community<T>> communities;
+        for (size_t c = 0; c < communitySizes.size(); ++c) {
+            if (communitySizes[c] > 0) {
+                slot[c] = static_cast<int>(communities.size());
+                communities.emplace_back();
+            }
+        }
+        for (const auto& [node, label] : labels) {
+            if (label >= 0) {
+                communities[slot[label]].addNode(node);
+            }
+        }
+        return communities;
+    }
+};
+
+#endif
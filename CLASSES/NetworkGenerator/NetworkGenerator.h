@@ -0,0 +1,438 @@
+#ifndef NETWORKGENERATOR_H
+#define NETWORKGENERATOR_H
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <map>
+#include <unordered_map>
+#include <string>        // For string operations
+#include <stdexcept>     // For exceptions
+#include <memory>        // For shared_ptr
+#include <algorithm>     // For sort, unique
+#include <cmath>         // For log, pow
+#include <cstdint>       // For uint32_t, uint64_t
+#include <random>        // For mt19937_64
+#include <thread>        // For std::thread
+#include <atomic>        // For the chunk counter
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+#include "../FileParsing/FileParsing.h"
+using namespace std;
+
+
+// Random weighted networks that keep the group structure of an observed
+// network (block model over hierarchicalCommunities).
+//
+// For every pair of groups (r, s) the observed weight W_rs is spread over the
+// N_rs node pairs of the block, so the expected weight of a pair is
+// W_rs / N_rs. WRG draws every pair weight from the geometric distribution
+// with that mean (Garlaschelli's weighted random graph). BWRN draws it from
+// the negative binomial distribution with that mean and the given success
+// probability q; a small q gives bursty weights, q -> 1 approaches Poisson
+// weights, and the shape that makes the mean match is r = mean q / (1 - q).
+//
+// Only the pairs with a non-zero weight are visited: the gaps between them
+// are drawn from a geometric distribution, so the cost follows the number
+// of generated edges rather than the number of node pairs. Every block is
+// split into chunks with their own mt19937_64 stream, derived from the seed,
+// the number of networks generated so far and the chunk index. Threads take
+// chunks from a shared counter and the chunks are concatenated in order, so
+// the network does not depend on the thread count.
+template <typename T>
+class NetworkGenerator {
+public:
+    using WeightedEdge = tuple<T, T, int>;
+
+private:
+    unsigned numThreads = 1;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    uint64_t generatedNetworks = 0;
+
+    // Expected number of edges sampled by one chunk
+    static constexpr double edgesPerChunk = 1 << 14;
+
+    struct SampledEdge {
+        uint32_t from;
+        uint32_t to;
+        int weight;
+    };
+
+    struct Block {
+        uint32_t first;     // group r
+        uint32_t second;    // group s, r <= s
+        uint64_t pairs;     // N_rs
+        double nonZero;     // probability that a pair gets an edge
+        double parameter;   // p of the geometric law, or the negative binomial shape
+    };
+
+    struct Chunk {
+        uint32_t block;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    // Node indices of every group, and names of the indices
+    struct BlockModel {
+        vector<T> nodes;
+        vector<vector<uint32_t>> groups;
+        vector<Block> blocks;
+    };
+
+    static uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // Uniform double in (0, 1]
+    static double uniform(mt19937_64& rng) {
+        return (static_cast<double>(rng() >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * Indexes the nodes and groups and sums the observed weight of every
+     * block. A node takes the first group that contains it; nodes of
+     * nodeEdges in no group form one extra group. Every edge is expected
+     * under both endpoints and is counted once, from its smaller endpoint.
+     */
+    static BlockModel buildBlockModel(const map<T, vector<pair<T, int>>>& nodeEdges,
+                                      const vector<Community<T>>& hierarchicalCommunities) {
+        BlockModel model;
+        unordered_map<T, uint32_t> indexOf;
+        vector<uint32_t> groupOf;
+        size_t members = 0;
+        for (const auto& community : hierarchicalCommunities) members += community.size();
+        indexOf.reserve(max(members, nodeEdges.size()));
+        auto addNode = [&](const T& node, uint32_t group) {
+            auto inserted = indexOf.try_emplace(node, static_cast<uint32_t>(model.nodes.size()));
+            if (inserted.second) {
+                model.nodes.push_back(node);
+                groupOf.push_back(group);
+            }
+            return inserted.first->second;
+        };
+
+        model.groups.resize(hierarchicalCommunities.size());
+        for (uint32_t group = 0; group < hierarchicalCommunities.size(); ++group) {
+            for (const T& node : hierarchicalCommunities[group].getNodes()) {
+                addNode(node, group);
+            }
+        }
+        uint32_t ungrouped = static_cast<uint32_t>(hierarchicalCommunities.size());
+        for (const auto& [node, neighbors] : nodeEdges) {
+            addNode(node, ungrouped);
+            for (const auto& neighbor : neighbors) {
+                addNode(neighbor.first, ungrouped);
+            }
+        }
+        if (groupOf.end() != find(groupOf.begin(), groupOf.end(), ungrouped)) {
+            model.groups.emplace_back();
+        }
+        for (uint32_t v = 0; v < groupOf.size(); ++v) {
+            model.groups[groupOf[v]].push_back(v);
+        }
+
+        // observed weight per block, keyed by r * groups + s and summed after sorting
+        uint64_t numGroups = model.groups.size();
+        vector<pair<uint64_t, double>> blockWeight;
+        for (const auto& [node, neighbors] : nodeEdges) {
+            uint64_t r = groupOf[indexOf.at(node)];
+            for (const auto& [neighbor, weight] : neighbors) {
+                if (!(node < neighbor)) continue;
+                uint64_t s = groupOf[indexOf.at(neighbor)];
+                blockWeight.emplace_back(min(r, s) * numGroups + max(r, s), weight);
+            }
+        }
+        sort(blockWeight.begin(), blockWeight.end());
+
+        for (size_t i = 0; i < blockWeight.size();) {
+            uint64_t key = blockWeight[i].first;
+            double weight = 0;
+            for (; i < blockWeight.size() && blockWeight[i].first == key; ++i) {
+                weight += blockWeight[i].second;
+            }
+            uint32_t r = static_cast<uint32_t>(key / numGroups), s = static_cast<uint32_t>(key % numGroups);
+            uint64_t a = model.groups[r].size(), b = model.groups[s].size();
+            uint64_t pairs = r == s ? a * (a - 1) / 2 : a * b;
+            if (weight > 0 && pairs > 0) {
+                model.blocks.push_back({r, s, pairs, weight / pairs, 0});
+            }
+        }
+        return model;
+    }
+
+    // Nodes of the pair with the given index in a block
+    static pair<uint32_t, uint32_t> pairAt(const BlockModel& model, const Block& block, uint64_t index) {
+        const vector<uint32_t>& first = model.groups[block.first];
+        if (block.first != block.second) {
+            const vector<uint32_t>& second = model.groups[block.second];
+            return {first[index / second.size()], second[index % second.size()]};
+        }
+        // index = i (i - 1) / 2 + j with j < i
+        uint64_t i = static_cast<uint64_t>((1 + sqrt(8.0 * static_cast<double>(index) + 1)) / 2);
+        while (i * (i - 1) / 2 > index) --i;
+        while ((i + 1) * i / 2 <= index) ++i;
+        return {first[i], first[index - i * (i - 1) / 2]};
+    }
+
+    /**
+     * Samples the edges of every block in parallel
+     * @param drawWeight Weight of a pair known to have an edge, >= 1
+     */
+    template <typename DrawWeight>
+    vector<SampledEdge> sampleEdges(const BlockModel& model, DrawWeight drawWeight) {
+        vector<Chunk> chunks;
+        for (uint32_t b = 0; b < model.blocks.size(); ++b) {
+            const Block& block = model.blocks[b];
+            if (block.nonZero <= 0) continue;
+            // in double first: a nearly empty block would overflow uint64_t
+            double pairsPerChunk = ceil(edgesPerChunk / block.nonZero);
+            uint64_t step = pairsPerChunk >= static_cast<double>(block.pairs)
+                ? block.pairs : max<uint64_t>(1, static_cast<uint64_t>(pairsPerChunk));
+            for (uint64_t begin = 0; begin < block.pairs;) {
+                uint64_t end = block.pairs - begin <= step ? block.pairs : begin + step;
+                chunks.push_back({b, begin, end});
+                begin = end;
+            }
+        }
+
+        uint64_t stream = mix(seed ^ mix(++generatedNetworks));
+        vector<vector<SampledEdge>> sampled(chunks.size());
+        runChunks(chunks.size(), [&](size_t c) {
+            const Chunk& chunk = chunks[c];
+            const Block& block = model.blocks[chunk.block];
+            mt19937_64 rng(mix(stream + c));
+            double logZero = log1p(-block.nonZero);
+            vector<SampledEdge>& out = sampled[c];
+            out.reserve(static_cast<size_t>((chunk.end - chunk.begin) * block.nonZero * 1.1) + 16);
+            uint64_t index = chunk.begin;
+            while (true) {
+                // pairs without an edge before the next one
+                if (block.nonZero < 1) {
+                    double gap = floor(log(uniform(rng)) / logZero);
+                    if (gap >= static_cast<double>(chunk.end - index)) break;
+                    index += static_cast<uint64_t>(gap);
+                }
+                if (index >= chunk.end) break;
+                auto [from, to] = pairAt(model, block, index);
+                out.push_back({from, to, drawWeight(block, rng)});
+                ++index;
+            }
+        });
+
+        // concatenate into one exactly sized buffer
+        vector<size_t> offset(chunks.size() + 1, 0);
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            offset[c + 1] = offset[c] + sampled[c].size();
+        }
+        vector<SampledEdge> edges(offset.back());
+        runChunks(chunks.size(), [&](size_t c) {
+            copy(sampled[c].begin(), sampled[c].end(), edges.begin() + offset[c]);
+            vector<SampledEdge>().swap(sampled[c]);
+        });
+        return edges;
+    }
+
+    vector<WeightedEdge> namedEdges(const BlockModel& model, const vector<SampledEdge>& edges) const {
+        vector<WeightedEdge> named(edges.size());
+        size_t step = 1 << 16;
+        runChunks((edges.size() + step - 1) / step, [&](size_t c) {
+            for (size_t i = c * step; i < min(edges.size(), (c + 1) * step); ++i) {
+                named[i] = WeightedEdge(model.nodes[edges[i].from], model.nodes[edges[i].to], edges[i].weight);
+            }
+        });
+        return named;
+    }
+
+    // Runs task(0) ... task(count - 1) on the worker threads
+    template <typename Task>
+    void runChunks(size_t count, Task task) const {
+        unsigned threads = static_cast<unsigned>(min<size_t>(numThreads, max<size_t>(count, 1)));
+        atomic<size_t> next(0);
+        auto work = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                task(i);
+            }
+        };
+        if (threads <= 1) {
+            work();
+            return;
+        }
+        vector<thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back(work);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+public:
+    NetworkGenerator() = default;
+
+    explicit NetworkGenerator(unsigned numThreads, uint64_t seed = 0x9E3779B97F4A7C15ULL) : seed(seed) {
+        setNumThreads(numThreads);
+    }
+
+    // 0 uses every hardware thread
+    void setNumThreads(unsigned threads) {
+        numThreads = threads == 0 ? max(1u, thread::hardware_concurrency()) : threads;
+    }
+
+    unsigned getNumThreads() const { return numThreads; }
+
+    // Restarts the sequence of generated networks
+    void setSeed(uint64_t newSeed) {
+        seed = newSeed;
+        generatedNetworks = 0;
+    }
+
+    /**
+     * Negative binomial weighted random network over the group structure
+     * @param nodeEdges Observed weighted neighbors of every node
+     * @param hierarchicalCommunities Groups whose block weights are kept
+     * @param probabilityOfSuccess Success probability q of the negative binomial, in (0, 1)
+     * @return Edges (node, node, weight >= 1)
+     */
+    vector<WeightedEdge> BWRN(const map<T, vector<pair<T, int>>>& nodeEdges,
+                              const vector<Community<T>>& hierarchicalCommunities,
+                              double probabilityOfSuccess) {
+        if (!(probabilityOfSuccess > 0 && probabilityOfSuccess < 1)) {
+            throw invalid_argument("Probability of success must be in (0, 1)");
+        }
+        double q = probabilityOfSuccess;
+        BlockModel model = buildBlockModel(nodeEdges, hierarchicalCommunities);
+        for (Block& block : model.blocks) {
+            block.parameter = block.nonZero * q / (1 - q);          // shape r
+            block.nonZero = -expm1(block.parameter * log(q));       // 1 - q^r
+        }
+        auto edges = sampleEdges(model, [q](const Block& block, mt19937_64& rng) {
+            // inverse CDF of the negative binomial conditioned on w >= 1;
+            // P(w + 1) / P(w) = (w + r) (1 - q) / (w + 1)
+            double r = block.parameter;
+            double probability = r * exp(r * log(q)) * (1 - q);
+            if (probability == 0) {
+                // P(1) underflows only for very large mean weights; use the
+                // normal approximation there
+                double mean = r * (1 - q) / q, deviation = sqrt(r * (1 - q)) / q;
+                double gaussian = sqrt(-2 * log(uniform(rng))) * cos(6.283185307179586 * uniform(rng));
+                return max(1, static_cast<int>(llround(mean + deviation * gaussian)));
+            }
+            double target = uniform(rng) * block.nonZero;
+            int weight = 1;
+            while (target > probability && probability > 0) {
+                target -= probability;
+                probability *= (weight + r) * (1 - q) / (weight + 1);
+                ++weight;
+            }
+            return weight;
+        });
+        return namedEdges(model, edges);
+    }
+
+    /**
+     * Weighted random graph over the group structure: geometric pair weights
+     * @param nodeEdges Observed weighted neighbors of every node
+     * @param hierarchicalCommunities Groups whose block weights are kept
+     * @return Edges (node, node, weight >= 1)
+     */
+    vector<WeightedEdge> WRG(const map<T, vector<pair<T, int>>>& nodeEdges,
+                             const vector<Community<T>>& hierarchicalCommunities) {
+        BlockModel model = buildBlockModel(nodeEdges, hierarchicalCommunities);
+        for (Block& block : model.blocks) {
+            double mean = block.nonZero;
+            block.parameter = mean / (1 + mean);  // P(w) = (1 - p) p^w
+            block.nonZero = block.parameter;
+        }
+        auto edges = sampleEdges(model, [](const Block& block, mt19937_64& rng) {
+            return 1 + static_cast<int>(floor(log(uniform(rng)) / log(block.parameter)));
+        });
+        return namedEdges(model, edges);
+    }
+
+    /**
+     * Replaces the node names of generated edges by ids read from a file,
+     * assigned in a random order; weights are dropped
+     * @param totalGeneratedEdges Generated edges
+     * @param randomNodeIdsFile Whitespace separated ids, at least numNodes of them
+     * @param numNodes Number of ids used from the file
+     * @return One (id, id) pair per edge
+     */
+    vector<pair<T, T>> randomizeNodeIds(const vector<WeightedEdge>& totalGeneratedEdges,
+                                        const string& randomNodeIdsFile, int numNodes) {
+        vector<T> ids;
+        ids.reserve(max(numNodes, 0));
+        ChunkedLineReader reader(randomNodeIdsFile);
+        const char* begin;
+        const char* end;
+        T id;
+        while (static_cast<int>(ids.size()) < numNodes && reader.nextLine(begin, end)) {
+            while (static_cast<int>(ids.size()) < numNodes && parseToken(begin, end, id)) {
+                ids.push_back(id);
+            }
+        }
+        if (static_cast<int>(ids.size()) < numNodes) {
+            throw runtime_error("Expected " + to_string(numNodes) + " node ids in " + randomNodeIdsFile);
+        }
+
+        vector<T> nodes;
+        nodes.reserve(2 * totalGeneratedEdges.size());
+        for (const auto& edge : totalGeneratedEdges) {
+            nodes.push_back(get<0>(edge));
+            nodes.push_back(get<1>(edge));
+        }
+        sort(nodes.begin(), nodes.end());
+        nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+        if (nodes.size() > ids.size()) {
+            throw invalid_argument("More generated nodes than node ids");
+        }
+
+        mt19937_64 rng(mix(seed ^ mix(++generatedNetworks)));
+        for (size_t i = ids.size(); i > 1; --i) {
+            swap(ids[i - 1], ids[rng() % i]);
+        }
+
+        vector<pair<T, T>> randomized(totalGeneratedEdges.size());
+        for (size_t i = 0; i < totalGeneratedEdges.size(); ++i) {
+            auto from = lower_bound(nodes.begin(), nodes.end(), get<0>(totalGeneratedEdges[i])) - nodes.begin();
+            auto to = lower_bound(nodes.begin(), nodes.end(), get<1>(totalGeneratedEdges[i])) - nodes.begin();
+            randomized[i] = {ids[from], ids[to]};
+        }
+        return randomized;
+    }
+
+    /**
+     * Builds a graph from generated edges in one bulk step
+     * @param edges Distinct edges (node, node, weight)
+     * @return Graph over the nodes of the edges
+     */
+    shared_ptr<Graph<T>> generateGraph(const vector<WeightedEdge>& edges) const {
+        vector<T> vertices;
+        vertices.reserve(2 * edges.size());
+        for (const auto& edge : edges) {
+            vertices.push_back(get<0>(edge));
+            vertices.push_back(get<1>(edge));
+        }
+        sort(vertices.begin(), vertices.end());
+        vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+
+        vector<typename Graph<T>::BulkEdge> bulk(edges.size());
+        size_t step = 1 << 16;
+        runChunks((edges.size() + step - 1) / step, [&](size_t c) {
+            for (size_t i = c * step; i < min(edges.size(), (c + 1) * step); ++i) {
+                auto from = lower_bound(vertices.begin(), vertices.end(), get<0>(edges[i])) - vertices.begin();
+                auto to = lower_bound(vertices.begin(), vertices.end(), get<1>(edges[i])) - vertices.begin();
+                bulk[i] = {static_cast<uint32_t>(from), static_cast<uint32_t>(to), static_cast<double>(get<2>(edges[i]))};
+            }
+        });
+        return make_shared<Graph<T>>(Graph<T>::buildBulk(vertices, bulk));
+    }
+};
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef VERTEXDICTIONARY_H
+#define VERTEXDICTIONARY_H
+
+#include <vector>
+#include <deque>         // For stable storage of the vertex names
+#include <string>
+#include <string_view>   // For allocation free lookups of string tokens
+#include <unordered_map>
+#include <utility>
+#include <cstdint>       // For uint32_t
+#include <stdexcept>     // For exceptions
+#include <algorithm>     // For sort
+#include <fstream>       // For file output
+#include <type_traits>   // For conditional_t
+#include "../Graph2/Graph2.h"
+#include "../Community/Community.h"
+#include "../FileParsing/FileParsing.h"
+using namespace std;
+
+
+/**
+ * Interns vertex ids of any type (usually string) to dense uint32_t ids,
+ * 0, 1, 2, ... in order of first appearance. Loading graphs and communities
+ * through a dictionary lets Graph<uint32_t>, Community<uint32_t> and
+ * CommunityComparison<uint32_t> do all the work on integers: adjacency
+ * entries and edgeLookup keys are 4 bytes instead of a heap-allocated
+ * string, and every hash is an integer hash. The names are only looked up
+ * again when results are written out.
+ *
+ * String tokens from a file are matched against string_views into the stored
+ * names, so only the first occurrence of a vertex allocates. Load every file
+ * of a dataset through the same dictionary to keep the ids consistent.
+ */
+template <typename T>
+class VertexDictionary {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+private:
+    using Key = conditional_t<is_same_v<T, string>, string_view, T>;
+
+    deque<T> names;                  // id -> vertex; a deque never moves stored names
+    unordered_map<Key, uint32_t> ids;
+
+    uint32_t add(const T& vertex) {
+        if (names.size() >= NOT_FOUND) {
+            throw std::overflow_error("Too many vertices for 32 bit ids");
+        }
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(vertex);
+        ids.emplace(Key(names.back()), id);
+        return id;
+    }
+
+    // Next whitespace separated token of [p, end), false at the end of the line
+    static bool nextToken(const char*& p, const char* end, string_view& token) {
+        skipBlanks(p, end);
+        if (p == end) {
+            return false;
+        }
+        token = string_view(p, static_cast<size_t>(tokenEnd(p, end) - p));
+        p += token.size();
+        return true;
+    }
+
+    // Id of a vertex token, interned if insert is set; NOT_FOUND for unknown
+    // vertices otherwise and for tokens that do not parse as a T
+    uint32_t idOfToken(string_view token, bool insert) {
+        if constexpr (is_same_v<T, string>) {
+            auto found = ids.find(token);
+            if (found != ids.end()) {
+                return found->second;
+            }
+            return insert ? add(string(token)) : NOT_FOUND;
+        } else {
+            const char* p = token.data();
+            T vertex;
+            if (!parseToken(p, token.data() + token.size(), vertex)) {
+                return NOT_FOUND;
+            }
+            return insert ? intern(vertex) : find(vertex);
+        }
+    }
+
+public:
+    VertexDictionary() = default;
+
+    // The lookup table points into names, so copies rebuild it
+    VertexDictionary(const VertexDictionary& other) : names(other.names) {
+        ids.reserve(names.size());
+        for (size_t id = 0; id < names.size(); ++id) {
+            ids.emplace(Key(names[id]), static_cast<uint32_t>(id));
+        }
+    }
+
+    VertexDictionary(VertexDictionary&&) = default;
+
+    VertexDictionary& operator=(VertexDictionary other) {
+        names.swap(other.names);
+        ids.swap(other.ids);
+        return *this;
+    }
+
+    void reserve(size_t count) { ids.reserve(count); }
+
+    size_t size() const { return names.size(); }
+
+    /**
+     * @param vertex Vertex to intern
+     * @return Its id, a new one if the vertex was not seen before
+     */
+    uint32_t intern(const T& vertex) {
+        auto found = ids.find(Key(vertex));
+        return found != ids.end() ? found->second : add(vertex);
+    }
+
+    /**
+     * @param vertex Vertex to look up
+     * @return Its id, or NOT_FOUND
+     */
+    uint32_t find(const T& vertex) const {
+        auto found = ids.find(Key(vertex));
+        return found != ids.end() ? found->second : NOT_FOUND;
+    }
+
+    bool contains(const T& vertex) const { return find(vertex) != NOT_FOUND; }
+
+    /**
+     * @param id Interned id
+     * @return The vertex with that id
+     */
+    const T& vertex(uint32_t id) const {
+        if (id >= names.size()) {
+            throw std::out_of_range("Unknown vertex id: " + to_string(id));
+        }
+        return names[id];
+    }
+
+    /**
+     * Loads a graph in the Graph(string filename) text format with every
+     * vertex replaced by its interned id
+     * @param filename Graph file
+     * @return Graph over the interned ids
+     */
+    Graph<uint32_t> loadGraph(const string& filename) {
+        ChunkedLineReader reader(filename);
+        const char* begin;
+        const char* end;
+        string_view token;
+
+        // Read the number of vertices
+        size_t numVertices;
+        if (!reader.nextLine(begin, end) || !parseToken(begin, end, numVertices)) {
+            throw std::runtime_error("Error reading number of vertices");
+        }
+        reserve(size() + numVertices);
+
+        // Read the vertices; the slots of buildBulk are positions in this line
+        if (!reader.nextLine(begin, end)) {
+            throw std::runtime_error("Error reading vertices");
+        }
+        vector<uint32_t> slotVertex;
+        slotVertex.reserve(numVertices);
+        while (nextToken(begin, end, token)) {
+            uint32_t id = idOfToken(token, true);
+            if (id == NOT_FOUND) {
+                throw std::runtime_error("Invalid vertex: " + string(token));
+            }
+            slotVertex.push_back(id);
+        }
+        if (slotVertex.size() != numVertices) {
+            throw std::runtime_error("Mismatch in vertex count: expected " +
+                                     to_string(numVertices) + ", got " +
+                                     to_string(slotVertex.size()));
+        }
+        vector<uint32_t> slotOf(size(), NOT_FOUND);
+        for (size_t slot = 0; slot < slotVertex.size(); ++slot) {
+            if (slotOf[slotVertex[slot]] != NOT_FOUND) {
+                throw std::invalid_argument("Vertex already exists in graph");
+            }
+            slotOf[slotVertex[slot]] = static_cast<uint32_t>(slot);
+        }
+
+        // Read the number of edges
+        size_t numEdges;
+        if (!reader.nextLine(begin, end) || !parseToken(begin, end, numEdges)) {
+            throw std::runtime_error("Error reading number of edges");
+        }
+
+        // Read the edges into a flat buffer of slot indices
+        vector<Graph<uint32_t>::BulkEdge> edges(numEdges);
+        for (size_t i = 0; i < numEdges; ++i) {
+            if (!reader.nextLine(begin, end)) {
+                throw std::runtime_error("Expected " + to_string(numEdges) +
+                                         " edges, but only found " + to_string(i));
+            }
+            uint32_t slots[2];
+            for (uint32_t& slot : slots) {
+                if (!nextToken(begin, end, token)) {
+                    throw std::runtime_error("Error parsing edge at line " + to_string(i+4));
+                }
+                uint32_t id = idOfToken(token, false);
+                slot = id < slotOf.size() ? slotOf[id] : NOT_FOUND;
+                if (slot == NOT_FOUND) {
+                    throw std::runtime_error("Vertex not found: " + string(token));
+                }
+            }
+            double weight;
+            if (!parseToken(begin, end, weight)) {
+                throw std::runtime_error("Error parsing edge at line " + to_string(i+4));
+            }
+            edges[i] = Graph<uint32_t>::BulkEdge{slots[0], slots[1], weight};
+        }
+
+        return Graph<uint32_t>::buildBulk(slotVertex, edges);
+    }
+
+    /**
+     * Loads communities from "node community" lines, one community per
+     * distinct community id in ascending id order, with the nodes interned
+     * @param filename Community file
+     * @return Communities of interned ids
+     */
+    vector<Community<uint32_t>> loadCommunities(const string& filename) {
+        ChunkedLineReader reader(filename);
+        const char* lineBegin;
+        const char* lineEnd;
+        string_view token;
+        vector<pair<int, uint32_t>> members;  // (community id, node id)
+        int communityId;
+
+        // lines without a node and an integer community id are skipped
+        while (reader.nextLine(lineBegin, lineEnd)) {
+            const char* p = lineBegin;
+            if (!nextToken(p, lineEnd, token) || !parseToken(p, lineEnd, communityId)) {
+                continue;
+            }
+            uint32_t id = idOfToken(token, true);
+            if (id != NOT_FOUND) {
+                members.emplace_back(communityId, id);
+            }
+        }
+
+        sort(members.begin(), members.end());
+        vector<Community<uint32_t>> communities;
+        vector<uint32_t> nodes;
+        for (size_t i = 0; i < members.size();) {
+            size_t j = i;
+            nodes.clear();
+            for (; j < members.size() && members[j].first == members[i].first; ++j) {
+                nodes.push_back(members[j].second);
+            }
+            communities.emplace_back();
+            communities.back().addNodes(nodes.begin(), nodes.end());
+            i = j;
+        }
+        return communities;
+    }
+
+    /**
+     * @param community Community of vertices
+     * @return The same community over interned ids, interning unseen vertices
+     */
+    Community<uint32_t> encode(const Community<T>& community) {
+        vector<uint32_t> nodes;
+        nodes.reserve(community.size());
+        for (const auto& node : community.getNodes()) {
+            nodes.push_back(intern(node));
+        }
+        sort(nodes.begin(), nodes.end());
+        Community<uint32_t> encoded;
+        encoded.addNodes(nodes.begin(), nodes.end());
+        return encoded;
+    }
+
+    vector<Community<uint32_t>> encode(const vector<Community<T>>& communities) {
+        vector<Community<uint32_t>> encoded;
+        encoded.reserve(communities.size());
+        for (const auto& community : communities) {
+            encoded.push_back(encode(community));
+        }
+        return encoded;
+    }
+
+    /**
+     * @param community Community of interned ids
+     * @return The same community over the original vertices
+     */
+    Community<T> decode(const Community<uint32_t>& community) const {
+        vector<T> nodes;
+        nodes.reserve(community.size());
+        for (uint32_t id : community.getNodes()) {
+            nodes.push_back(vertex(id));
+        }
+        sort(nodes.begin(), nodes.end());
+        Community<T> decoded;
+        decoded.addNodes(nodes.begin(), nodes.end());
+        return decoded;
+    }
+
+    vector<Community<T>> decode(const vector<Community<uint32_t>>& communities) const {
+        vector<Community<T>> decoded;
+        decoded.reserve(communities.size());
+        for (const auto& community : communities) {
+            decoded.push_back(decode(community));
+        }
+        return decoded;
+    }
+
+    /**
+     * Writes "node community" lines with the original vertices, in the
+     * format of LouvainDetection::writeCommunities, without decoding the
+     * communities first
+     * @param communities Communities of interned ids
+     * @param outputFile Output file
+     */
+    void writeCommunities(const vector<Community<uint32_t>>& communities, const string& outputFile) const {
+        ofstream file(outputFile);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + outputFile);
+        }
+        for (size_t communityId = 0; communityId < communities.size(); ++communityId) {
+            for (uint32_t id : communities[communityId].getNodes()) {
+                file << vertex(id) << " " << communityId << "\n";
+            }
+        }
+    }
+};
+
+#endif
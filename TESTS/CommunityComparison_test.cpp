@@ -6,6 +6,9 @@
 #include <memory>
 #include <fstream>
 #include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <set>
 
 // Helper function to create test communities
 std::vector<Community<int>> createTestCommunities() {
@@ -89,6 +92,55 @@ void testLoadCommunities() {
     std::cout << "loadCommunities test passed!" << std::endl;
 }
 
+// Test the flat label loader and unusual community files
+void testLoadCommunityLabels() {
+    std::cout << "Testing loadCommunityLabels and irregular files..." << std::endl;
+    
+    std::string filename = "test_communities_irregular.txt";
+    {
+        std::ofstream file(filename);
+        file << "5 10\r\n";        // CRLF line ending
+        file << "# comment\n";      // not a node line
+        file << "3 -2\n";           // negative community id
+        file << "\n";
+        file << "4 10 extra\n";     // trailing tokens are ignored
+        file << "5 10\n";           // duplicate line
+        file << "1 7\n";
+        file << "5 7\n";            // node in two communities
+        file << "2 10";              // no final newline
+    }
+    
+    CommunityComparison<int> cc;
+    auto labels = cc.loadCommunityLabels(filename);
+    assert(labels.first == std::vector<int>({5, 3, 4, 5, 1, 5, 2}));
+    assert(labels.second == std::vector<int>({10, -2, 10, 10, 7, 7, 10}));
+    
+    // Communities come in ascending id order: -2, 7, 10
+    std::vector<Community<int>> communities = cc.loadCommunities(filename);
+    assert(communities.size() == 3);
+    assert(communities[0].getNodesSorted() == std::vector<int>({3}));
+    assert(communities[1].getNodesSorted() == std::vector<int>({1, 5}));
+    assert(communities[2].getNodesSorted() == std::vector<int>({2, 4, 5}));
+    
+    // Non-integral node ids
+    CommunityComparison<std::string> named;
+    std::vector<Community<std::string>> namedCommunities = named.loadCommunities(filename);
+    assert(namedCommunities.size() == 3);
+    assert(namedCommunities[2].getNodesSorted() == std::vector<std::string>({"2", "4", "5"}));
+    
+    std::remove(filename.c_str());
+    
+    bool threw = false;
+    try {
+        cc.loadCommunities("missing_communities.txt");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "loadCommunityLabels test passed!" << std::endl;
+}
+
 // Test getNodeSet method
 void testGetNodeSet() {
     std::cout << "Testing getNodeSet method..." << std::endl;
@@ -237,6 +289,360 @@ void testConvertCommunitiesToLabelVectors() {
     std::cout << "convertCommunitiesToLabelVectors test passed!" << std::endl;
 }
 
+// Reference label vectors: common nodes in order, first community containing each
+template <typename T>
+std::pair<std::vector<int>, std::vector<int>> referenceLabelVectors(const std::vector<Community<T>>& trueCommunities,
+                                                                    const std::vector<Community<T>>& predCommunities) {
+    std::set<T> trueNodes, predNodes;
+    for (const auto& community : trueCommunities) trueNodes.insert(community.getNodes().begin(), community.getNodes().end());
+    for (const auto& community : predCommunities) predNodes.insert(community.getNodes().begin(), community.getNodes().end());
+    
+    std::vector<int> trueLabels, predLabels;
+    for (const T& node : trueNodes) {
+        if (predNodes.find(node) == predNodes.end()) continue;
+        for (size_t c = 0; c < trueCommunities.size(); c++) {
+            if (trueCommunities[c].containsNode(node)) { trueLabels.push_back(c); break; }
+        }
+        for (size_t c = 0; c < predCommunities.size(); c++) {
+            if (predCommunities[c].containsNode(node)) { predLabels.push_back(c); break; }
+        }
+    }
+    return std::make_pair(trueLabels, predLabels);
+}
+
+// Test the dense and hashed label vector paths against the reference
+void testLabelVectorPaths() {
+    std::cout << "Testing label vector conversion paths..." << std::endl;
+    CommunityComparison<int> cc;
+    
+    // Dense ids with overlaps and nodes missing from one side
+    std::vector<Community<int>> dense1(4), dense2(3);
+    for (int node = 0; node < 400; node++) {
+        dense1[node % 4].addNode(node);
+        if (node % 7 != 0) dense2[(node / 50) % 3].addNode(node);
+    }
+    dense1[0].addNode(5);
+    dense2[2].addNode(401);
+    assert(cc.convertCommunitiesToLabelVectors(dense1, dense2) == referenceLabelVectors(dense1, dense2));
+    
+    // Sparse and negative ids take the hashed path
+    std::vector<Community<int>> sparse1(2), sparse2(2);
+    for (int node : {-5, 3, 1000000, 7}) sparse1[node % 2 != 0].addNode(node);
+    for (int node : {3, 7, 1000000, 9}) sparse2[node > 5].addNode(node);
+    assert(cc.convertCommunitiesToLabelVectors(sparse1, sparse2) == referenceLabelVectors(sparse1, sparse2));
+    
+    // Non-integral ids
+    CommunityComparison<std::string> named;
+    std::vector<Community<std::string>> names1(2), names2(2);
+    for (std::string node : {"a", "b", "c"}) names1[0].addNode(node);
+    for (std::string node : {"d", "e"}) names1[1].addNode(node);
+    for (std::string node : {"a", "d"}) names2[0].addNode(node);
+    for (std::string node : {"b", "c", "e", "f"}) names2[1].addNode(node);
+    assert(named.convertCommunitiesToLabelVectors(names1, names2) == referenceLabelVectors(names1, names2));
+    
+    std::cout << "Label vector conversion paths test passed!" << std::endl;
+}
+
+// NMI with std::map counts, as computed before the contingency table
+double referenceNMI(const std::vector<int>& labels1, const std::vector<int>& labels2) {
+    std::map<int, int> counts1, counts2;
+    std::map<std::pair<int, int>, int> jointCounts;
+    for (size_t i = 0; i < labels1.size(); i++) {
+        counts1[labels1[i]]++;
+        counts2[labels2[i]]++;
+        jointCounts[std::make_pair(labels1[i], labels2[i])]++;
+    }
+    double n = static_cast<double>(labels1.size());
+    double h1 = 0, h2 = 0, h12 = 0;
+    for (const auto& pair : counts1) { double p = pair.second / n; h1 -= p * log2(p); }
+    for (const auto& pair : counts2) { double p = pair.second / n; h2 -= p * log2(p); }
+    for (const auto& pair : jointCounts) { double p = pair.second / n; h12 -= p * log2(p); }
+    if (h1 + h2 == 0) return 0;
+    return 2 * (h1 + h2 - h12) / (h1 + h2);
+}
+
+// Test the contingency table against std::map counting
+void testContingencyTable() {
+    std::cout << "Testing contingency table..." << std::endl;
+    
+    ContingencyTable table({0, 0, 1, 1, 2}, {5, 5, 5, -3, -3});
+    assert(table.getSampleCount() == 5);
+    assert(table.getRowSums() == std::vector<uint64_t>({2, 2, 1}));
+    assert(table.getColumnSums() == std::vector<uint64_t>({2, 3}));
+    assert(table.getCells().size() == 4);
+    assert(table.getCells()[0].row == 0 && table.getCells()[0].column == 1 && table.getCells()[0].count == 2);
+    
+    // Few labels (flat joint table), many labels (hashed joint table) and sparse labels
+    std::srand(5);
+    for (int numLabels : {3, 40, 5000}) {
+        std::vector<int> labels1(20000), labels2(20000);
+        for (size_t i = 0; i < labels1.size(); i++) {
+            labels1[i] = std::rand() % numLabels;
+            labels2[i] = (labels1[i] + std::rand() % 3) * (numLabels > 1000 ? 100003 : 1) - 7;
+        }
+        CommunityComparison<int> cc;
+        assert(cc.normalizedMutualInfo(labels1, labels2) == referenceNMI(labels1, labels2));
+    }
+    
+    CommunityComparison<int> cc;
+    assert(cc.normalizedMutualInfo({}, {}) == 0);
+    assert(cc.normalizedMutualInfo({4, 4, 4}, {1, 1, 1}) == 0);
+    
+    bool threw = false;
+    try {
+        ContingencyTable mismatched({1, 2}, {1});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Contingency table test passed!" << std::endl;
+}
+
+// Expected mutual information summed term by term over every pair of clusters
+double referenceEMI(const ContingencyTable& table) {
+    double n = static_cast<double>(table.getSampleCount());
+    double emi = 0;
+    for (uint64_t a : table.getRowSums()) {
+        for (uint64_t b : table.getColumnSums()) {
+            double da = static_cast<double>(a), db = static_cast<double>(b);
+            for (double k = std::max(1.0, da + db - n); k <= std::min(da, db); k += 1) {
+                double logP = lgamma(da + 1) + lgamma(db + 1) + lgamma(n - da + 1) + lgamma(n - db + 1) - lgamma(n + 1)
+                            - lgamma(k + 1) - lgamma(da - k + 1) - lgamma(db - k + 1) - lgamma(n - da - db + k + 1);
+                emi += k / n * log2(n * k / (da * db)) * exp(logP);
+            }
+        }
+    }
+    return emi;
+}
+
+// Test ARI, AMI, VI and F1 from the contingency table
+void testPartitionMetrics() {
+    std::cout << "Testing partition similarity metrics..." << std::endl;
+    
+    // Reference values computed independently
+    ContingencyTable table({0, 0, 0, 1, 1, 1}, {0, 0, 1, 1, 2, 2});
+    PartitionMetrics metrics = table.allMetrics();
+    assert(std::abs(metrics.nmi - 0.5158037429793887) < 1e-12);
+    assert(std::abs(metrics.ari - 0.24242424242424246) < 1e-12);
+    assert(std::abs(metrics.ami - 0.29879245817089006) < 1e-12);
+    assert(std::abs(metrics.vi - 1.251629167387823) < 1e-12);
+    assert(std::abs(metrics.f1 - 0.7333333333333334) < 1e-12);
+    assert(std::abs(table.expectedMutualInformation() - 0.4) < 1e-12);
+    
+    ContingencyTable table2({0, 0, 0, 1, 1, 1, 2, 2, 2, 2, 3, 3}, {0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 3, 1});
+    assert(std::abs(table2.adjustedRandIndex() - 0.09465020576131687) < 1e-12);
+    assert(std::abs(table2.adjustedMutualInformation() - 0.16472172742460514) < 1e-12);
+    assert(std::abs(table2.variationOfInformation() - 2.0220552088741996) < 1e-12);
+    assert(std::abs(table2.bestMatchF1() - 0.5952380952380952) < 1e-12);
+    
+    // Identical partitions (with relabeling)
+    PartitionMetrics same = ContingencyTable({0, 0, 1, 1, 2}, {7, 7, 3, 3, 9}).allMetrics();
+    assert(std::abs(same.ari - 1) < 1e-12 && std::abs(same.ami - 1) < 1e-12);
+    assert(std::abs(same.vi) < 1e-12 && same.f1 == 1);
+    
+    // Grouping clusters by size and stopping early keep the expected MI exact
+    std::srand(3);
+    std::vector<int> labels1(5000), labels2(5000);
+    for (size_t i = 0; i < labels1.size(); i++) {
+        labels1[i] = static_cast<int>(i % 60) + (i % 7 == 0 ? 60 : 0);
+        labels2[i] = std::rand() % 45;
+    }
+    ContingencyTable large(labels1, labels2);
+    assert(std::abs(large.expectedMutualInformation() - referenceEMI(large)) < 1e-10);
+    assert(std::abs(large.adjustedMutualInformation()) < 0.05);
+    assert(std::abs(large.adjustedRandIndex()) < 0.05);
+    
+    // calculateMetrics matches the individual scores
+    CommunityComparison<int> cc;
+    std::vector<Community<int>> truth(2), predicted(3);
+    for (int node : {1, 2, 3, 4}) truth[0].addNode(node);
+    for (int node : {5, 6, 7, 8}) truth[1].addNode(node);
+    for (int node : {1, 2, 3}) predicted[0].addNode(node);
+    for (int node : {4, 5, 6}) predicted[1].addNode(node);
+    for (int node : {7, 8, 9}) predicted[2].addNode(node);
+    PartitionMetrics fromCommunities = cc.calculateMetrics(truth, predicted);
+    assert(fromCommunities.nmi == cc.calculateNMI(truth, predicted));
+    auto labels = cc.convertCommunitiesToLabelVectors(truth, predicted);
+    assert(fromCommunities.ari == ContingencyTable(labels.first, labels.second).adjustedRandIndex());
+    
+    std::cout << "Partition similarity metrics test passed!" << std::endl;
+}
+
+// McDaid overlapping NMI over every pair of clusters, for cross-checking
+double referenceOverlappingNMI(const std::vector<std::set<int>>& x, const std::vector<std::set<int>>& y, double n) {
+    auto h = [](double p) { return p > 0 ? -p * std::log2(p) : 0.0; };
+    auto clusterEntropy = [&](double size) { return h(size / n) + h(1 - size / n); };
+    auto conditional = [&](const std::vector<std::set<int>>& from, const std::vector<std::set<int>>& given) {
+        double total = 0;
+        for (const auto& a : from) {
+            double best = clusterEntropy(a.size());
+            for (const auto& b : given) {
+                double common = 0;
+                for (int node : a) common += b.count(node);
+                double h11 = h(common / n), h10 = h((a.size() - common) / n);
+                double h01 = h((b.size() - common) / n), h00 = h((n - a.size() - b.size() + common) / n);
+                if (h11 + h00 > h01 + h10) {
+                    best = std::min(best, h11 + h10 + h01 + h00 - clusterEntropy(b.size()));
+                }
+            }
+            total += best;
+        }
+        return total;
+    };
+    double hx = 0, hy = 0;
+    for (const auto& a : x) hx += clusterEntropy(a.size());
+    for (const auto& b : y) hy += clusterEntropy(b.size());
+    return (hx - conditional(x, y) + hy - conditional(y, x)) / 2 / std::max(hx, hy);
+}
+
+// Test NMI of overlapping covers
+void testOverlappingNMI() {
+    std::cout << "Testing overlapping NMI..." << std::endl;
+    
+    auto makeCover = [](const std::vector<std::vector<int>>& clusters) {
+        std::vector<Community<int>> cover(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i++) {
+            for (int node : clusters[i]) cover[i].addNode(node);
+        }
+        return cover;
+    };
+    CommunityComparison<int> cc;
+    
+    // Reference values computed independently
+    auto x = makeCover({{1, 2, 3, 4, 5}, {5, 6, 7, 8}, {8, 9, 10, 11, 12}});
+    auto y = makeCover({{1, 2, 3}, {3, 4, 5, 6}, {7, 8, 9}, {9, 10, 11, 12}});
+    assert(std::abs(cc.calculateLFKNMI(x, y) - 0.38265887054821424) < 1e-12);
+    assert(std::abs(cc.calculateOverlappingNMI(x, y) - 0.3538650786468274) < 1e-12);
+    assert(std::abs(cc.calculateOverlappingNMI(y, x) - 0.3538650786468274) < 1e-12);
+    CoverOverlap overlap = cc.buildCoverOverlap(x, y);
+    assert(overlap.getNodeCount() == 12);
+    assert(overlap.getCells().size() == 6);
+    
+    // Identical covers score 1, whatever the order of the communities
+    auto shuffled = makeCover({{8, 9, 10, 11, 12}, {1, 2, 3, 4, 5}, {5, 6, 7, 8}});
+    assert(std::abs(cc.calculateOverlappingNMI(x, shuffled) - 1) < 1e-12);
+    assert(std::abs(cc.calculateLFKNMI(x, shuffled) - 1) < 1e-12);
+    
+    // The best match of {0} is the disjoint community of 600 nodes
+    std::vector<int> rest, low, high;
+    for (int node = 1; node < 1000; node++) rest.push_back(node);
+    for (int node = 0; node < 1000; node++) (node < 400 ? low : high).push_back(node);
+    auto single = makeCover({{0}, rest});
+    auto halves = makeCover({low, high});
+    assert(std::abs(cc.calculateLFKNMI(single, halves) - 0.058668651301585384) < 1e-12);
+    assert(std::abs(cc.calculateOverlappingNMI(single, halves) - 0.001362593923772503) < 1e-12);
+    
+    // Sparse counts agree with comparing every pair of clusters
+    std::srand(11);
+    std::vector<std::set<int>> clustersX(40), clustersY(30);
+    for (int node = 0; node < 600; node++) {
+        for (int k = 0; k < 1 + node % 3; k++) clustersX[std::rand() % 40].insert(node);
+        clustersY[(node / 20 + std::rand() % 2) % 30].insert(node);
+    }
+    std::vector<std::vector<int>> listsX, listsY;
+    for (const auto& c : clustersX) listsX.emplace_back(c.begin(), c.end());
+    for (const auto& c : clustersY) listsY.emplace_back(c.begin(), c.end());
+    double reference = referenceOverlappingNMI(clustersX, clustersY, 600);
+    assert(std::abs(cc.calculateOverlappingNMI(makeCover(listsX), makeCover(listsY)) - reference) < 1e-12);
+    
+    // Ids that need the hash index
+    CommunityComparison<std::string> stringComparison;
+    std::vector<Community<std::string>> a(2), b(2);
+    for (const char* node : {"a", "b", "c"}) a[0].addNode(node);
+    for (const char* node : {"c", "d"}) a[1].addNode(node);
+    for (const char* node : {"d", "c"}) b[0].addNode(node);
+    for (const char* node : {"a", "c", "b"}) b[1].addNode(node);
+    assert(std::abs(stringComparison.calculateOverlappingNMI(a, b) - 1) < 1e-12);
+    
+    std::cout << "Overlapping NMI test passed!" << std::endl;
+}
+
+// Test scoring many partitions against one prepared ground truth
+void testBatchCalculateNMI() {
+    std::cout << "Testing batch NMI against a prepared ground truth..." << std::endl;
+    std::srand(9);
+    
+    std::vector<Community<int>> truth(10);
+    for (int node = 0; node < 2000; node++) {
+        truth[node % 10].addNode(node);
+    }
+    std::vector<std::vector<Community<int>>> predictions;
+    for (int run = 0; run < 6; run++) {
+        std::vector<Community<int>> predicted(8 + run);
+        for (int node = 0; node < 2100; node++) {
+            if (std::rand() % 20 == 0) continue;  // some nodes missing
+            int community = std::rand() % 4 == 0 ? std::rand() % predicted.size() : node % predicted.size();
+            predicted[community].addNode(node);
+        }
+        predicted[0].addNode(7);  // an overlapping node
+        predictions.push_back(predicted);
+    }
+    
+    CommunityComparison<int> cc;
+    bool threw = false;
+    try {
+        cc.calculateNMIToGroundTruth(predictions[0]);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    cc.prepareGroundTruth(truth);
+    assert(cc.hasGroundTruth());
+    for (unsigned threads : {1u, 3u}) {
+        auto results = cc.batchCalculateNMI(predictions, threads);
+        assert(results.size() == predictions.size());
+        for (size_t i = 0; i < results.size(); i++) {
+            assert(results[i].name == std::to_string(i));
+            assert(results[i].numCommunities == predictions[i].size());
+            assert(results[i].nmi == cc.calculateNMI(truth, predictions[i]));
+            assert(results[i].ari == cc.calculateMetrics(truth, predictions[i]).ari);
+            assert(results[i].commonNodes == cc.convertCommunitiesToLabelVectors(truth, predictions[i]).first.size());
+        }
+    }
+    
+    // Sparse ids go through the hashed index
+    std::vector<Community<int>> sparseTruth(2), sparsePred(2);
+    for (int node : {1, 500000, 900000}) sparseTruth[0].addNode(node);
+    for (int node : {2, 700000}) sparseTruth[1].addNode(node);
+    for (int node : {1, 2, 3}) sparsePred[0].addNode(node);
+    for (int node : {500000, 700000, 900000}) sparsePred[1].addNode(node);
+    cc.prepareGroundTruth(sparseTruth);
+    assert(cc.calculateNMIToGroundTruth(sparsePred) == cc.calculateNMI(sparseTruth, sparsePred));
+    
+    // Community files are loaded by the workers
+    cc.prepareGroundTruth(truth);
+    std::vector<std::string> files;
+    for (size_t i = 0; i < 3; i++) {
+        files.push_back("batch_prediction_" + std::to_string(i) + ".txt");
+        std::ofstream out(files.back());
+        for (size_t c = 0; c < predictions[i].size(); c++) {
+            for (int node : predictions[i][c].getNodes()) {
+                out << node << " " << c << "\n";
+            }
+        }
+    }
+    auto fileResults = cc.batchCalculateNMI(files, 2);
+    for (size_t i = 0; i < files.size(); i++) {
+        assert(fileResults[i].name == files[i]);
+        assert(fileResults[i].nmi == cc.calculateNMI(truth, cc.loadCommunities(files[i])));
+    }
+    
+    threw = false;
+    try {
+        cc.batchCalculateNMI(std::vector<std::string>{files[0], "missing_prediction.txt"}, 2);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    for (const auto& file : files) {
+        std::remove(file.c_str());
+    }
+    
+    std::cout << "Batch NMI test passed!" << std::endl;
+}
+
 // Test calculateNMI method
 void testCalculateNMI() {
     std::cout << "Testing calculateNMI method..." << std::endl;
@@ -452,11 +858,17 @@ int main() {
     std::cout << "Running CommunityComparison tests..." << std::endl;
     
     testLoadCommunities();
+    testLoadCommunityLabels();
     testGetNodeSet();
     testHandleMissingNodes();
     testGetCommonNodes();
     testConvertCommunitiesToLabelVectors();
+    testLabelVectorPaths();
     testCalculateNMI();
+    testContingencyTable();
+    testBatchCalculateNMI();
+    testPartitionMetrics();
+    testOverlappingNMI();
     testCreateNodeToCommunityMap();
     testConvertMapsToLabelVectors();
     testPrintCommunityStatistics();
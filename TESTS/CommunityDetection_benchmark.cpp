@@ -0,0 +1,115 @@
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include "../CLASSES/LabelPropagation/LabelPropagation.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+// Throughput benchmarks for the community detectors. Sizes can be overridden:
+//     community_detection_benchmark [numVertices] [averageDegree] [numCommunities] [mixing] [maxThreads]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Planted partition graph: numCommunities equal blocks, each vertex gets
+// averageDegree / 2 edges of which a fraction `mixing` leaves its block.
+std::shared_ptr<Graph<int>> createPlantedPartitionGraph(int numVertices, int averageDegree, int numCommunities,
+                                                        double mixing, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> anyVertex(0, numVertices - 1);
+    int blockSize = numVertices / numCommunities;
+    std::uniform_int_distribution<int> inBlock(0, blockSize - 1);
+
+    auto g = std::make_shared<Graph<int>>();
+    for (int v = 0; v < numVertices; ++v) {
+        g->addVertex(v);
+    }
+    for (int v = 0; v < numVertices; ++v) {
+        int block = std::min(v / blockSize, numCommunities - 1);
+        for (int k = 0; k < averageDegree / 2; ++k) {
+            int u = coin(rng) < mixing ? anyVertex(rng) : block * blockSize + inBlock(rng);
+            if (u != v && !g->hasEdge(u, v)) {
+                g->addEdge(u, v, 1.0);
+            }
+        }
+    }
+    return g;
+}
+
+void benchmarkLouvain(const std::shared_ptr<Graph<int>>& g) {
+    std::cout << "Louvain" << std::endl;
+
+    auto start = Clock::now();
+    CsrGraph<int> csr = g->freeze();
+    double freezeSeconds = secondsSince(start);
+
+    LouvainDetection<int> louvain;
+    start = Clock::now();
+    std::vector<Community<int>> communities = louvain.detectCommunitiesFromCsr(csr);
+    double detectSeconds = secondsSince(start);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "  freeze:            " << freezeSeconds << " s" << std::endl
+              << "  detection:         " << detectSeconds << " s ("
+              << g->getEdgeCount() / detectSeconds / 1e6 << " M edges/s)" << std::endl
+              << "  levels:            " << louvain.getLastLevelCount() << std::endl
+              << "  communities:       " << communities.size() << std::endl
+              << "  modularity:        " << std::setprecision(4) << louvain.getLastModularity() << std::endl;
+}
+
+// Strong scaling of label propagation from 1 to maxThreads threads
+void benchmarkLabelPropagation(const std::shared_ptr<Graph<int>>& g, unsigned maxThreads) {
+    std::cout << "Label propagation (hardware threads: " << std::thread::hardware_concurrency() << ")" << std::endl;
+    CsrGraph<int> csr = g->freeze();
+
+    double sequentialSeconds = 0;
+    double sequentialModularity = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        LabelPropagationDetection<int> lpa(threads);
+        auto start = Clock::now();
+        std::vector<Community<int>> communities = lpa.detectCommunitiesFromCsr(csr);
+        double seconds = secondsSince(start);
+        double modularity = g->calculateModularity(communities);
+        if (threads == 1) {
+            sequentialSeconds = seconds;
+            sequentialModularity = modularity;
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  threads " << std::setw(2) << threads << ": " << seconds << " s ("
+                  << g->getEdgeCount() / seconds / 1e6 << " M edges/s, speedup "
+                  << sequentialSeconds / seconds << "x), " << lpa.getLastIterationCount() << " iterations, "
+                  << lpa.getLastColorCount() << " colors, " << communities.size() << " communities, modularity "
+                  << std::setprecision(4) << modularity
+                  << " (diff " << std::scientific << std::setprecision(1) << modularity - sequentialModularity
+                  << ")" << std::defaultfloat << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numVertices = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int averageDegree = argc > 2 ? std::stoi(argv[2]) : 12;
+    int numCommunities = argc > 3 ? std::stoi(argv[3]) : 1000;
+    double mixing = argc > 4 ? std::stod(argv[4]) : 0.3;
+    unsigned maxThreads = argc > 5 ? std::stoul(argv[5]) : std::max(8u, std::thread::hardware_concurrency());
+
+    std::cout << "Running community detection benchmarks..." << std::endl;
+
+    auto start = Clock::now();
+    auto g = createPlantedPartitionGraph(numVertices, averageDegree, numCommunities, mixing, 42);
+    std::cout << "Planted partition graph: " << g->getVertexCount() << " vertices, "
+              << g->getEdgeCount() << " edges, " << numCommunities << " blocks, mixing " << mixing
+              << " (built in " << std::fixed << std::setprecision(2) << secondsSince(start) << " s)" << std::endl;
+
+    benchmarkLouvain(g);
+    benchmarkLabelPropagation(g, maxThreads);
+
+    return 0;
+}
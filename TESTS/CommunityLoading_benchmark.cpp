@@ -0,0 +1,102 @@
+#include "../CLASSES/CommunityComparison/CommunityComparison.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <fstream>
+#include <map>
+#include <cstdio>
+#include <unistd.h>        // For fork
+#include <sys/wait.h>      // For waitpid
+#include <sys/resource.h>  // For getrusage
+
+// Time and peak RSS of loading a "node community" file. Every loader runs in
+// its own forked process so the peak RSS of one does not hide another's.
+//     community_loading_benchmark [numLines] [numCommunities]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The loader before chunked parsing: istringstream per line, a map of
+// communities, and a copy of every community into the result
+std::vector<Community<int>> legacyLoadCommunities(const std::string& filename) {
+    std::ifstream myfile(filename);
+    std::map<int, Community<int>> communityMap;
+    std::string line;
+    while (getline(myfile, line)) {
+        std::istringstream iss(line);
+        int nodeId;
+        int communityId;
+        if (!(iss >> nodeId >> communityId)) {
+            continue;
+        }
+        if (communityMap.find(communityId) == communityMap.end()) {
+            communityMap[communityId] = Community<int>();
+        }
+        communityMap[communityId].addNode(nodeId);
+    }
+    std::vector<Community<int>> communities;
+    for (const auto& pair : communityMap) {
+        communities.push_back(pair.second);
+    }
+    return communities;
+}
+
+long peakRssKilobytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template <typename Loader>
+void measureInChild(const std::string& name, Loader load) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        long baseline = peakRssKilobytes();
+        auto start = Clock::now();
+        size_t count = load();
+        double seconds = secondsSince(start);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  " << std::left << std::setw(24) << name << std::right
+                  << std::setw(7) << seconds << " s   peak RSS " << std::setw(7)
+                  << (peakRssKilobytes() - baseline) / 1024.0 << " MB above baseline   (" << count << ")" << std::endl;
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+int main(int argc, char* argv[]) {
+    size_t numLines = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    int numCommunities = argc > 2 ? std::stoi(argv[2]) : 100000;
+    std::string filename = "community_loading_benchmark.txt";
+
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> anyCommunity(0, numCommunities - 1);
+        std::ofstream out(filename);
+        for (size_t node = 0; node < numLines; ++node) {
+            out << node << " " << anyCommunity(rng) << "\n";
+        }
+    }
+    std::cout << "Loading " << numLines << " lines, " << numCommunities << " communities" << std::endl;
+
+    measureInChild("legacy loadCommunities", [&] { return legacyLoadCommunities(filename).size(); });
+    measureInChild("loadCommunities", [&] {
+        CommunityComparison<int> cc;
+        return cc.loadCommunities(filename).size();
+    });
+    measureInChild("loadCommunityLabels", [&] {
+        CommunityComparison<int> cc;
+        return cc.loadCommunityLabels(filename).first.size();
+    });
+
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <vector>
+
+// Compares the Community<T> node storage policies on integer ids. Sizes can be overridden:
+//     community_benchmark [communitySize] [idRange]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Bytes held per member, from the layout of each policy
+size_t approximateBytes(const SetStorage<int>& storage, const std::vector<int>&) {
+    // red-black tree node: color, parent, left, right, value (padded to 8 bytes)
+    return storage.size() * ((4 * sizeof(void*) + sizeof(int) + 7) / 8 * 8);
+}
+
+size_t approximateBytes(const SortedVectorStorage<int>& storage, const std::vector<int>&) {
+    return storage.size() * sizeof(int);
+}
+
+size_t approximateBytes(const BitmapStorage<int>&, const std::vector<int>& ids) {
+    int maxId = 0;
+    for (int id : ids) maxId = std::max(maxId, id);
+    return (static_cast<size_t>(maxId) / 64 + 1) * sizeof(uint64_t);
+}
+
+template <typename Storage>
+void benchmarkStorage(const std::string& name, const std::vector<int>& first, const std::vector<int>& second,
+                      const std::vector<int>& queries) {
+    auto start = Clock::now();
+    Community<int, Storage> a;
+    Community<int, Storage> b;
+    for (int id : first) a.addNode(id);
+    for (int id : second) b.addNode(id);
+    double buildSeconds = secondsSince(start);
+
+    start = Clock::now();
+    size_t hits = 0;
+    for (int id : queries) {
+        hits += a.containsNode(id);
+    }
+    double lookupSeconds = secondsSince(start);
+
+    start = Clock::now();
+    Community<int, Storage> unionCommunity = a.createUnion(b);
+    double unionSeconds = secondsSince(start);
+
+    start = Clock::now();
+    Community<int, Storage> intersection = a.createIntersection(b);
+    double intersectionSeconds = secondsSince(start);
+
+    start = Clock::now();
+    long long checksum = 0;
+    for (int id : a.getNodes()) {
+        checksum += id;
+    }
+    double scanSeconds = secondsSince(start);
+
+    std::vector<int> sortedFirst = a.getNodesSorted();
+    Storage storage;
+    for (int id : sortedFirst) storage.insert(id);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "  " << std::left << std::setw(14) << name << std::right
+              << " build " << std::setw(8) << buildSeconds * 1e3 << " ms"
+              << "  contains " << std::setw(7) << lookupSeconds * 1e9 / queries.size() << " ns"
+              << "  union " << std::setw(8) << unionSeconds * 1e3 << " ms"
+              << "  intersect " << std::setw(8) << intersectionSeconds * 1e3 << " ms"
+              << "  scan " << std::setw(7) << scanSeconds * 1e3 << " ms"
+              << "  ~" << std::setprecision(1) << std::setw(5)
+              << static_cast<double>(approximateBytes(storage, sortedFirst)) / a.size() << " B/node"
+              << "  (" << hits << " hits, " << unionCommunity.size() << " union, "
+              << intersection.size() << " common, checksum " << checksum % 1000 << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int communitySize = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int idRange = argc > 2 ? std::stoi(argv[2]) : 1000000;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> anyId(0, idRange - 1);
+    std::vector<int> first(communitySize), second(communitySize), queries(2000000);
+    for (int& id : first) id = anyId(rng);
+    for (int& id : second) id = anyId(rng);
+    for (int& id : queries) id = anyId(rng);
+
+    std::cout << "Community storage (" << communitySize << " random ids in [0, " << idRange << "))" << std::endl;
+    benchmarkStorage<SetStorage<int>>("set", first, second, queries);
+    benchmarkStorage<SortedVectorStorage<int>>("sorted vector", first, second, queries);
+    benchmarkStorage<BitmapStorage<int>>("bitmap", first, second, queries);
+
+    // Ids arriving in increasing order, as when copying from another community
+    std::sort(first.begin(), first.end());
+    std::sort(second.begin(), second.end());
+    std::cout << "Community storage, ids inserted in increasing order" << std::endl;
+    benchmarkStorage<SetStorage<int>>("set", first, second, queries);
+    benchmarkStorage<SortedVectorStorage<int>>("sorted vector", first, second, queries);
+    benchmarkStorage<BitmapStorage<int>>("bitmap", first, second, queries);
+
+    return 0;
+}
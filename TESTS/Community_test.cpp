@@ -4,6 +4,9 @@
 #include <string>
 #include <cassert>
 #include <memory>
+#include <cmath>
+#include <map>
+#include <unordered_map>
 
 // Create a test graph for community testing
 std::shared_ptr<Graph<int>> createTestGraphForCommunity() {
@@ -88,6 +91,144 @@ void testCommunityMerge() {
     std::cout << "Community merge test passed!" << std::endl;
 }
 
+// Test that merging keeps cached weights equal to a full recalculation
+void testCommunityMergeWeights() {
+    std::cout << "Testing community merge weight updates..." << std::endl;
+    
+    auto graph = createTestGraphForCommunity();
+    graph->addEdge(2, 2, 4.0);
+    graph->addEdge(1, 5, 0.5);
+    
+    std::vector<Community<int>> parts(4);
+    parts[0].addNode(1);
+    parts[0].addNode(2);
+    parts[1].addNode(3);
+    parts[2].addNode(4);
+    parts[2].addNode(5);
+    parts[3].addNode(6);
+    for (auto& part : parts) {
+        part.calculateWeights(graph);
+    }
+    
+    // Smaller community merged into a larger one and the other way round
+    parts[0].merge(parts[1]);
+    parts[3].merge(parts[2]);
+    parts[0].merge(parts[3]);
+    
+    Community<int> expected = parts[0];
+    expected.calculateWeights(graph);
+    assert(parts[0].size() == 6);
+    assert(std::abs(parts[0].getInternalWeight() - expected.getInternalWeight()) < 1e-12);
+    assert(std::abs(parts[0].getExternalWeight() - expected.getExternalWeight()) < 1e-12);
+    assert(std::abs(parts[0].getExternalWeight()) < 1e-12);
+    
+    // Overlapping communities fall back to a full recalculation
+    Community<int> left;
+    left.addNode(1);
+    left.addNode(2);
+    left.addNode(3);
+    Community<int> right;
+    right.addNode(3);
+    right.addNode(4);
+    left.calculateWeights(graph);
+    right.calculateWeights(graph);
+    left.merge(right);
+    expected = left;
+    expected.calculateWeights(graph);
+    assert(left.getInternalWeight() == expected.getInternalWeight());
+    assert(left.getExternalWeight() == expected.getExternalWeight());
+    
+    // Weights cached before a change to the members or to the graph are not
+    // trusted: each merge below must match a recalculation on the 4-cycle
+    // 1-2-3-4 with unit weights
+    auto cycle = [] {
+        auto g = std::make_shared<Graph<int>>();
+        g->addEdge(1, 2, 1.0);
+        g->addEdge(2, 3, 1.0);
+        g->addEdge(3, 4, 1.0);
+        g->addEdge(4, 1, 1.0);
+        return g;
+    };
+    auto single = [](int node, std::shared_ptr<Graph<int>>& g) {
+        Community<int> community;
+        community.addNode(node);
+        community.calculateWeights(g);
+        return community;
+    };
+    auto mergedWeights = [](Community<int>& a, Community<int>& b) {
+        a.merge(b);
+        return std::make_pair(a.getInternalWeight(), a.getExternalWeight());
+    };
+    using Weights = std::pair<double, double>;
+    
+    auto g = cycle();
+    Community<int> a = single(1, g), b = single(3, g);
+    assert(a.weightsCurrent());
+    a.addNode(2);                                   // {1,2} + {3}
+    assert(!a.weightsCurrent());
+    assert(mergedWeights(a, b) == Weights(1.0, 1.0));
+    assert(a.weightsCurrent());
+    
+    a = single(1, g), b = single(3, g);
+    b.addNode(4);                                   // {1} + {3,4}
+    assert(mergedWeights(a, b) == Weights(1.0, 1.0));
+    
+    a = single(1, g), b = single(3, g);
+    std::vector<int> more = {2, 4};
+    a.addNodes(more.begin(), more.begin() + 1);     // {1,2} + {3}
+    assert(mergedWeights(a, b) == Weights(1.0, 1.0));
+    
+    a = single(1, g), b = single(3, g);
+    a.addNode(2);
+    a.calculateWeights(g);
+    a.removeNode(2);                                // {1} + {3}
+    assert(mergedWeights(a, b) == Weights(0.0, 2.0));
+    
+    a = single(1, g), b = single(4, g);
+    Community<int> c = single(3, g);
+    b.merge(c);                                     // weights of {3,4} kept current
+    assert(b.weightsCurrent());
+    assert(mergedWeights(a, b) == Weights(1.0, 1.0));
+    
+    a = single(1, g), b = single(3, g);
+    a.addNode(2);
+    g->addEdge(1, 3, 5.0);                          // {1,2} + {3} with a chord
+    assert(mergedWeights(a, b) == Weights(3.5, 1.0));
+    
+    g = cycle();
+    a = single(1, g), b = single(2, g);
+    g->addEdge(1, 3, 5.0);                          // graph changed, members not
+    assert(!a.weightsCurrent() && !b.weightsCurrent());
+    assert(mergedWeights(a, b) == Weights(0.5, 3.5));
+    
+    g = cycle();
+    a = single(1, g), b = single(2, g);
+    g->removeEdge(1, 2);
+    assert(mergedWeights(a, b) == Weights(0.0, 1.0));
+    
+    g = cycle();
+    a = single(1, g), b = single(2, g);
+    g->removeVertex(4);
+    assert(mergedWeights(a, b) == Weights(0.5, 0.5));
+    
+    g = cycle();
+    a = single(1, g), b = single(2, g);
+    g->applyBatch({{1, 2, 3.0}}, {{1, 2}});
+    assert(mergedWeights(a, b) == Weights(1.5, 1.0));
+    
+    g = cycle();
+    a = single(1, g), b = single(2, g);
+    auto heavier = std::make_shared<Graph<int>>();
+    heavier->addEdge(1, 2, 1.0);
+    heavier->addEdge(2, 3, 2.0);
+    heavier->addEdge(3, 4, 1.0);
+    heavier->addEdge(4, 1, 1.0);
+    *g = *heavier;                                  // as many changes, other weights
+    assert(mergedWeights(a, b) == Weights(0.5, 1.5));
+    
+    std::cout << "Community merge weight updates test passed!" << std::endl;
+}
+
 // Test community set operations
 void testCommunitySetOperations() {
     std::cout << "Testing community set operations..." << std::endl;
@@ -146,6 +287,126 @@ void testCommunityWeights() {
     std::cout << "Community weight calculations test passed!" << std::endl;
 }
 
+// Test that the batch weight calculation matches the per-community one
+void testCommunityWeightsBatch() {
+    std::cout << "Testing batch community weight calculations..." << std::endl;
+    
+    auto graph = createTestGraphForCommunity();
+    graph->addVertex(7);
+    graph->addEdge(6, 7, 2.0);
+    graph->addEdge(5, 5, 3.0);
+    
+    std::vector<Community<int>> communities(3);
+    for (int node : {1, 2, 3}) communities[0].addNode(node);
+    for (int node : {4, 5, 6}) communities[1].addNode(node);
+    communities[2].addNode(8);  // not in the graph
+    
+    std::vector<Community<int>> batch = communities;
+    Community<int>::calculateWeights(batch, graph);
+    
+    for (size_t c = 0; c < communities.size(); c++) {
+        communities[c].calculateWeights(graph);
+        assert(communities[c].getInternalWeight() == batch[c].getInternalWeight());
+        assert(communities[c].getExternalWeight() == batch[c].getExternalWeight());
+    }
+    
+    // 3 edges * 5.0 (+ the 3.0 self-loop) halved, and the 1.0 and 2.0 cut edges halved
+    assert(batch[0].getInternalWeight() == 7.5);
+    assert(batch[1].getInternalWeight() == 9.0);
+    assert(batch[1].getExternalWeight() == 1.5);
+    assert(batch[2].getInternalWeight() == 0.0 && batch[2].getExternalWeight() == 0.0);
+    
+    // Overlapping communities are scored one by one
+    std::vector<Community<int>> overlapping(2);
+    for (int node : {1, 2, 3, 4}) overlapping[0].addNode(node);
+    for (int node : {4, 5}) overlapping[1].addNode(node);
+    Community<int>::calculateWeights(overlapping, graph);
+    assert(overlapping[0].getInternalWeight() == 8.0);
+    assert(overlapping[0].getExternalWeight() == 5.0);
+    assert(overlapping[1].getInternalWeight() == 4.0);
+    
+    std::cout << "Batch community weight calculations test passed!" << std::endl;
+}
+
+// Exercise one storage policy against the default std::set storage
+template <typename Storage>
+void checkStoragePolicy(std::shared_ptr<Graph<int>> graph) {
+    Community<int, Storage> community1;
+    Community<int, Storage> community2;
+    for (int node : {130, 3, 1, 2, 64, 3}) community1.addNode(node);
+    for (int node : {2, 64, 4, 200}) community2.addNode(node);
+    
+    assert(community1.size() == 5);
+    assert(community1.containsNode(130) && community1.containsNode(64));
+    assert(!community1.containsNode(4) && !community1.containsNode(1000));
+    assert(community1.getNodesSorted() == std::vector<int>({1, 2, 3, 64, 130}));
+    
+    community1.removeNode(130);
+    community1.removeNode(7);
+    assert(community1.size() == 4);
+    assert(!community1.containsNode(130));
+    
+    Community<int, Storage> unionCommunity = community1.createUnion(community2);
+    assert(unionCommunity.getNodesSorted() == std::vector<int>({1, 2, 3, 4, 64, 200}));
+    Community<int, Storage> intersectionCommunity = community1.createIntersection(community2);
+    assert(intersectionCommunity.getNodesSorted() == std::vector<int>({2, 64}));
+    assert(intersectionCommunity.size() == 2);
+    
+    // Removing the largest id leaves an equal community
+    Community<int, Storage> copy = community1;
+    copy.addNode(500);
+    assert(!(copy == community1));
+    copy.removeNode(500);
+    assert(copy == community1);
+    
+    // Range inserts, sorted or not, merge into the existing members
+    std::vector<int> more = {300, 1, 150, 64};
+    copy.addNodes(more.begin(), more.end());
+    assert(copy.getNodesSorted() == std::vector<int>({1, 2, 3, 64, 150, 300}));
+    
+    size_t visited = 0;
+    for (int node : community1.getNodes()) {
+        assert(community1.containsNode(node));
+        visited++;
+    }
+    assert(visited == community1.size());
+    
+    // Weights agree with the default storage
+    Community<int, Storage> left;
+    Community<int, Storage> right;
+    Community<int> expected;
+    for (int node : {1, 2}) { left.addNode(node); expected.addNode(node); }
+    for (int node : {3, 4}) { right.addNode(node); expected.addNode(node); }
+    left.calculateWeights(graph);
+    right.calculateWeights(graph);
+    left.merge(right);
+    expected.calculateWeights(graph);
+    assert(left.size() == 4);
+    assert(left.getInternalWeight() == expected.getInternalWeight());
+    assert(left.getExternalWeight() == expected.getExternalWeight());
+}
+
+// Test the sorted vector and bitmap storage policies
+void testCommunityStoragePolicies() {
+    std::cout << "Testing community storage policies..." << std::endl;
+    
+    auto graph = createTestGraphForCommunity();
+    checkStoragePolicy<SetStorage<int>>(graph);
+    checkStoragePolicy<SortedVectorStorage<int>>(graph);
+    checkStoragePolicy<BitmapStorage<int>>(graph);
+    
+    bool threw = false;
+    try {
+        Community<int, BitmapStorage<int>> negative;
+        negative.addNode(-1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "Community storage policies test passed!" << std::endl;
+}
+
 // Test community equality
 void testCommunityEquality() {
     std::cout << "Testing community equality..." << std::endl;
@@ -170,14 +431,57 @@ void testCommunityEquality() {
     std::cout << "Community equality test passed!" << std::endl;
 }
 
+// Test ordering and hashing communities as map keys
+void testCommunityOrderingAndHash() {
+    std::cout << "Testing community ordering and hash..." << std::endl;
+    
+    Community<int> small, forward, backward, other;
+    small.addNode(9);
+    for (int node : {4, 1, 7}) forward.addNode(node);
+    for (int node : {7, 4, 1}) backward.addNode(node);
+    for (int node : {1, 4, 8}) other.addNode(node);
+    
+    // smaller communities first, then by sorted members
+    assert(small < forward && !(forward < small));
+    assert(forward < other && !(other < forward));
+    assert(!(forward < backward) && !(backward < forward));
+    
+    // the fingerprint depends only on the member set
+    assert(forward.fingerprint() == backward.fingerprint());
+    assert(forward.fingerprint() != other.fingerprint());
+    Community<int, SortedVectorStorage<int>> sorted;
+    Community<int, BitmapStorage<int>> bitmap;
+    for (int node : {7, 1, 4}) {
+        sorted.addNode(node);
+        bitmap.addNode(node);
+    }
+    assert(sorted.fingerprint() == forward.fingerprint());
+    assert(bitmap.fingerprint() == forward.fingerprint());
+    
+    std::map<Community<int>, int> ordered;
+    std::unordered_map<Community<int>, int, CommunityHash<int>> hashed;
+    for (const auto& community : {forward, other, backward, small}) {
+        ordered[community]++;
+        hashed[community]++;
+    }
+    assert(ordered.size() == 3 && ordered[forward] == 2);
+    assert(hashed.size() == 3 && hashed[backward] == 2);
+    
+    std::cout << "Community ordering and hash test passed!" << std::endl;
+}
+
 int main() {
     std::cout << "Running Community tests..." << std::endl;
     
     testCommunityNodeOperations();
     testCommunityMerge();
+    testCommunityMergeWeights();
     testCommunitySetOperations();
     testCommunityWeights();
+    testCommunityWeightsBatch();
     testCommunityEquality();
+    testCommunityStoragePolicies();
+    testCommunityOrderingAndHash();
     
     std::cout << "All Community tests passed!" << std::endl;
     return 0;
@@ -0,0 +1,255 @@
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/CsrGraph/CsrGraph.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cstddef>
+
+// Utility function to create a simple test graph (vertex ids deliberately not dense)
+Graph<int> createSparseIdGraph() {
+    Graph<int> g;
+    g.addVertex(40);
+    g.addVertex(10);
+    g.addVertex(30);
+    g.addVertex(20);
+    g.addVertex(50); // isolated vertex
+
+    g.addEdge(10, 20, 1.0);
+    g.addEdge(20, 30, 2.0);
+    g.addEdge(30, 40, 3.0);
+    g.addEdge(40, 10, 4.0);
+    g.addEdge(10, 30, 5.0);
+
+    return g;
+}
+
+// Test the vertex <-> dense id mapping
+void testIdMapping() {
+    std::cout << "Testing CSR id mapping..." << std::endl;
+    Graph<int> g = createSparseIdGraph();
+    CsrGraph<int> csr = g.freeze();
+
+    assert(csr.getVertexCount() == 5);
+    // ids follow the sorted vertex order
+    assert(csr.getId(10) == 0);
+    assert(csr.getId(20) == 1);
+    assert(csr.getId(50) == 4);
+    assert(csr.getVertex(2) == 30);
+    assert(csr.hasVertex(40));
+    assert(!csr.hasVertex(60));
+
+    bool threw = false;
+    try {
+        csr.getId(60);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "CSR id mapping test passed!" << std::endl;
+}
+
+// Test that the snapshot agrees with the source graph
+void testMatchesGraph() {
+    std::cout << "Testing CSR snapshot against source graph..." << std::endl;
+    Graph<int> g = createSparseIdGraph();
+    CsrGraph<int> csr = g.freeze();
+
+    assert(csr.getEdgeCount() == g.getEdgeCount());
+    assert(csr.getTotalWeight() == g.getTotalWeight());
+    assert(csr.getEntryCount() == 2 * g.getEdgeCount());
+
+    for (const int& vertex : g.getVertices()) {
+        uint32_t id = csr.getId(vertex);
+        assert(static_cast<int>(csr.getDegree(id)) == g.getDegree(vertex));
+        assert(csr.getWeightedDegree(id) == g.getWeightedDegree(vertex));
+
+        CsrNeighborRange range = csr.neighbors(id);
+        for (size_t i = 0; i < range.size(); ++i) {
+            int neighbor = csr.getVertex(range.target(i));
+            assert(g.hasEdge(vertex, neighbor));
+            assert(g.getEdgeWeight(vertex, neighbor) == range.weight(i));
+            // slices are sorted by neighbor id
+            if (i > 0) {
+                assert(range.target(i - 1) < range.target(i));
+            }
+        }
+    }
+
+    assert(csr.neighbors(csr.getId(50)).empty());
+
+    std::cout << "CSR snapshot test passed!" << std::endl;
+}
+
+// Test edge queries on the snapshot
+void testEdgeQueries() {
+    std::cout << "Testing CSR edge queries..." << std::endl;
+    Graph<int> g = createSparseIdGraph();
+    CsrGraph<int> csr = g.freeze();
+
+    assert(csr.hasEdge(csr.getId(10), csr.getId(30)));
+    assert(csr.hasEdge(csr.getId(30), csr.getId(10)));
+    assert(!csr.hasEdge(csr.getId(20), csr.getId(40)));
+    assert(csr.getEdgeWeight(csr.getId(40), csr.getId(10)) == 4.0);
+
+    bool threw = false;
+    try {
+        csr.getEdgeWeight(csr.getId(20), csr.getId(50));
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "CSR edge queries test passed!" << std::endl;
+}
+
+// Test snapshots of empty and string graphs
+void testOtherGraphs() {
+    std::cout << "Testing CSR snapshot of empty and string graphs..." << std::endl;
+    Graph<int> empty;
+    CsrGraph<int> emptyCsr = empty.freeze();
+    assert(emptyCsr.getVertexCount() == 0);
+    assert(emptyCsr.getEdgeCount() == 0);
+    assert(emptyCsr.getEntryCount() == 0);
+    assert(emptyCsr.getOffsets()[0] == 0);
+
+    Graph<std::string> g;
+    g.addEdge("b", "a", 2.0);
+    g.addEdge("b", "c", 3.0);
+    CsrGraph<std::string> csr = g.freeze();
+    assert(csr.getVertex(0) == "a");
+    assert(csr.getDegree(csr.getId("b")) == 2);
+    assert(csr.getWeightedDegree(csr.getId("b")) == 5.0);
+
+    std::cout << "CSR snapshot of empty and string graphs test passed!" << std::endl;
+}
+
+// Test the binary format round trip through a memory mapped file
+void testBinaryFile() {
+    std::cout << "Testing binary CSR file..." << std::endl;
+    Graph<int> g = createSparseIdGraph();
+    g.saveToBinaryFile("test_graph.csr");
+
+    CsrGraph<int> csr = g.freeze();
+    CsrGraph<int> mapped = CsrGraph<int>::loadBinary("test_graph.csr");
+
+    assert(mapped.getVertexCount() == csr.getVertexCount());
+    assert(mapped.getEdgeCount() == csr.getEdgeCount());
+    assert(mapped.getEntryCount() == csr.getEntryCount());
+    assert(mapped.getTotalWeight() == csr.getTotalWeight());
+    for (uint32_t id = 0; id < csr.getVertexCount(); ++id) {
+        assert(mapped.getVertex(id) == csr.getVertex(id));
+        assert(mapped.getWeightedDegree(id) == csr.getWeightedDegree(id));
+        CsrNeighborRange expected = csr.neighbors(id);
+        CsrNeighborRange actual = mapped.neighbors(id);
+        assert(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            assert(actual.target(i) == expected.target(i));
+            assert(actual.weight(i) == expected.weight(i));
+        }
+    }
+    assert(mapped.getId(30) == 2);
+    assert(mapped.getEdgeWeight(mapped.getId(10), mapped.getId(30)) == 5.0);
+
+    // copies share the mapping and keep it alive
+    CsrGraph<int> copy = mapped;
+    mapped = CsrGraph<int>();
+    assert(copy.getEdgeWeight(copy.getId(30), copy.getId(40)) == 3.0);
+
+    // a file with different id width is rejected
+    bool threw = false;
+    try {
+        CsrGraph<long long>::loadBinary("test_graph.csr");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // so is a text file
+    g.saveToFile("test_graph_text.txt");
+    threw = false;
+    try {
+        CsrGraph<int>::loadBinary("test_graph_text.txt");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // so are files whose header or arrays would lead queries outside the mapping
+    std::ifstream in("test_graph.csr", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    size_t offsetsAt = sizeof(CsrFileHeader) + 24;             // 5 ids of 4 bytes, 8-byte aligned
+    size_t targetsAt = bytes.size() - csr.getEntryCount() * 4;
+    auto rejects = [&](size_t at, uint64_t value, size_t width) {
+        std::string corrupt = bytes;
+        memcpy(&corrupt[at], &value, width);
+        std::ofstream("test_graph_corrupt.csr", std::ios::binary) << corrupt;
+        try {
+            CsrGraph<int>::loadBinary("test_graph_corrupt.csr");
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(!rejects(offsetsAt, 0, 8));                              // unchanged
+    assert(rejects(offsetof(CsrFileHeader, numVertices), uint64_t(1) << 62, 8));
+    assert(rejects(offsetof(CsrFileHeader, numEntries), ~uint64_t(0) / 4, 8));
+    assert(rejects(offsetsAt + 8, 1000, 8));                        // out of bounds
+    assert(rejects(offsetsAt + 16, 0, 8));                          // decreasing
+    assert(rejects(targetsAt + 4, 5, 4));                           // no such vertex
+
+    std::remove("test_graph.csr");
+    std::remove("test_graph_text.txt");
+    std::remove("test_graph_corrupt.csr");
+
+    std::cout << "Binary CSR file test passed!" << std::endl;
+}
+
+// Test the sequential modularity scan against Graph<T>
+void testModularity() {
+    std::cout << "Testing CSR modularity..." << std::endl;
+    Graph<int> g = createSparseIdGraph();
+    g.addEdge(50, 50, 1.5); // self-loop counts towards K only
+    CsrGraph<int> csr = g.freeze();
+
+    std::unordered_map<int, int> partition = {{10, 0}, {20, 0}, {30, 1}, {40, 1}, {50, 2}};
+    std::vector<int> labels(csr.getVertexCount());
+    for (const auto& [vertex, label] : partition) {
+        labels[csr.getId(vertex)] = label;
+    }
+    assert(std::abs(csr.calculateModularity(labels) - g.calculateModularity(partition)) < 1e-12);
+
+    // unassigned vertices contribute nothing
+    labels[csr.getId(50)] = -1;
+    partition.erase(50);
+    assert(std::abs(csr.calculateModularity(labels) - g.calculateModularity(partition)) < 1e-12);
+
+    bool threw = false;
+    try {
+        csr.calculateModularity(std::vector<int>(2, 0));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "CSR modularity test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running CsrGraph tests..." << std::endl;
+
+    testIdMapping();
+    testMatchesGraph();
+    testEdgeQueries();
+    testOtherGraphs();
+    testBinaryFile();
+    testModularity();
+
+    std::cout << "All CsrGraph tests passed!" << std::endl;
+    return 0;
+}
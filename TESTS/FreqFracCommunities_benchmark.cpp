@@ -0,0 +1,86 @@
+#include "../CLASSES/FreqFracCommunities/FreqFracCommunities.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <fstream>
+#include <map>
+#include <cstdio>
+
+// Counting the distinct groups of many generated partitions: an ordered
+// map keyed by Community (set comparisons on every step) against the
+// fingerprint-hashed, threaded countNetworkGroups.
+//     freq_frac_communities_benchmark [numFiles] [numNodes] [maxThreads]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int numFiles = argc > 1 ? std::stoi(argv[1]) : 1000;
+    int numNodes = argc > 2 ? std::stoi(argv[2]) : 10000;
+    unsigned maxThreads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 4;
+    const int groupSize = 20;
+    const double moved = 0.002;  // chance a node leaves its group in a generated file
+
+    // Groups of 20 consecutive nodes, a few nodes moved in every file
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> anyGroup(0, numNodes / groupSize - 1);
+    std::vector<std::string> files;
+    for (int file = 1; file <= numFiles; ++file) {
+        files.push_back("./freq_frac_benchmark" + std::to_string(file) + ".txt");
+        std::ofstream out(files.back());
+        for (int node = 0; node < numNodes; ++node) {
+            out << node << " " << (coin(rng) < moved ? anyGroup(rng) : node / groupSize) << "\n";
+        }
+    }
+    {
+        std::ofstream original("freq_frac_benchmark_original.txt");
+        for (int node = 0; node < numNodes; ++node) {
+            original << node << " " << node / groupSize << "\n";
+        }
+    }
+    std::cout << "Counting the groups of " << numFiles << " files of " << numNodes << " nodes" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    FreqFracHelper<int> helper;
+    std::vector<int> nodes = helper.readOriginalCommunityNodes("freq_frac_benchmark_original.txt");
+
+    auto start = Clock::now();
+    std::map<Community<int>, double> ordered;
+    for (const auto& file : files) {
+        for (auto& group : helper.readNetworkGroups(file, nodes)) {
+            ordered[group] += 1.0 / numFiles;
+        }
+    }
+    std::cout << "  " << std::left << std::setw(28) << "map<Community> 1 thread" << std::right
+              << std::setw(7) << secondsSince(start) << " s   (" << ordered.size() << " groups)" << std::endl;
+
+    FreqFracHelper<int>::GroupFrequencies frequencies;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        helper.setNumThreads(threads);
+        start = Clock::now();
+        frequencies = helper.countNetworkGroups(files, nodes);
+        std::string name = "countNetworkGroups " + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        std::cout << "  " << std::left << std::setw(28) << name << std::right
+                  << std::setw(7) << secondsSince(start) << " s   (" << frequencies.size() << " groups)" << std::endl;
+    }
+
+    for (const char* freqFrac : {"freq", "frac"}) {
+        start = Clock::now();
+        auto consensus = helper.freqFracBasedPredictions(frequencies, nodes, freqFrac);
+        std::cout << "  " << std::left << std::setw(28) << std::string(freqFrac) + " consensus" << std::right
+                  << std::setw(7) << secondsSince(start) << " s   (" << consensus.first.size()
+                  << " communities, penalty " << std::setprecision(4) << consensus.second << std::setprecision(2) << ")" << std::endl;
+    }
+
+    for (const auto& file : files) {
+        std::remove(file.c_str());
+    }
+    std::remove("freq_frac_benchmark_original.txt");
+    return 0;
+}
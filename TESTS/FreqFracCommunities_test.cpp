@@ -0,0 +1,174 @@
+#include "../CLASSES/FreqFracCommunities/FreqFracCommunities.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+// Original network: 60 nodes in 6 groups of 10. Generated files 1-6 repeat
+// it, files 7-10 merge the first two groups; every file also lists a node
+// outside the original network.
+const int GENERATED_FILES = 10;
+
+int generatedGroup(int node, int file) {
+    int group = node / 10;
+    return file >= 7 && group == 1 ? 0 : group;
+}
+
+void writeTestFiles() {
+    std::ofstream original("freqfrac_original.txt");
+    for (int node = 0; node < 60; node++) {
+        original << node << " " << node / 10 << "\n";
+    }
+    for (int file = 1; file <= GENERATED_FILES; file++) {
+        std::ofstream generated("./freqfrac_groups" + std::to_string(file) + ".txt");
+        // listed backwards, so groups are not read in sorted order
+        for (int node = 59; node >= 0; node--) {
+            generated << node << " " << generatedGroup(node, file) << "\n";
+        }
+        generated << "999 0\n";
+    }
+}
+
+void removeTestFiles() {
+    std::remove("freqfrac_original.txt");
+    for (int file = 1; file <= GENERATED_FILES; file++) {
+        std::remove(("./freqfrac_groups" + std::to_string(file) + ".txt").c_str());
+    }
+    for (const char* suffix : {"_freq.txt", "_freq_score.txt", "_frac.txt", "_frac_score.txt"}) {
+        std::remove((std::string("freqfrac_out") + suffix).c_str());
+    }
+}
+
+std::vector<std::string> generatedFiles() {
+    std::vector<std::string> files;
+    for (int file = 1; file <= GENERATED_FILES; file++) {
+        files.push_back("./freqfrac_groups" + std::to_string(file) + ".txt");
+    }
+    return files;
+}
+
+Community<int> range(int first, int last) {
+    Community<int> community;
+    for (int node = first; node < last; node++) {
+        community.addNode(node);
+    }
+    return community;
+}
+
+// Test counting the distinct groups of the generated files
+void testCountNetworkGroups() {
+    std::cout << "Testing group counting..." << std::endl;
+
+    FreqFracHelper<int> helper;
+    std::vector<int> nodes = helper.readOriginalCommunityNodes("freqfrac_original.txt");
+    assert(nodes.size() == 60 && nodes.front() == 0 && nodes.back() == 59);
+
+    auto groups = helper.readNetworkGroups("./freqfrac_groups7.txt", nodes);
+    assert(groups.size() == 5);
+    assert(groups.back() == range(0, 20));  // the outside node is skipped
+
+    auto frequencies = helper.countNetworkGroups(generatedFiles(), nodes);
+    assert(frequencies.size() == 7);
+    assert(std::abs(frequencies.at(range(0, 10)) - 0.6) < 1e-12);
+    assert(std::abs(frequencies.at(range(10, 20)) - 0.6) < 1e-12);
+    assert(std::abs(frequencies.at(range(0, 20)) - 0.4) < 1e-12);
+    for (int group = 2; group < 6; group++) {
+        assert(frequencies.at(range(10 * group, 10 * group + 10)) == 1.0);
+    }
+
+    // The thread count does not change the counts
+    FreqFracHelper<int> parallel(4);
+    assert(parallel.countNetworkGroups(generatedFiles(), nodes) == frequencies);
+
+    bool threw = false;
+    try {
+        parallel.countNetworkGroups({"./freqfrac_groups1.txt", "./freqfrac_missing.txt"}, nodes);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Group counting test passed!" << std::endl;
+}
+
+// Test the frequency- and fraction-based consensus and the penalties
+void testConsensus() {
+    std::cout << "Testing consensus communities..." << std::endl;
+
+    FreqFracHelper<int> helper;
+    std::vector<int> nodes = helper.readOriginalCommunityNodes("freqfrac_original.txt");
+    auto frequencies = helper.countNetworkGroups(generatedFiles(), nodes);
+
+    // By frequency the two groups seen in 6 files beat their merge seen in 4
+    auto [byFrequency, frequencyPenalty] = helper.freqFracBasedPredictions(frequencies, nodes, "freq");
+    assert(byFrequency.size() == 6);
+    for (int group = 0; group < 6; group++) {
+        assert(std::find(byFrequency.begin(), byFrequency.end(), range(10 * group, 10 * group + 10)) != byFrequency.end());
+    }
+    assert(std::abs(frequencyPenalty - 20 * 0.4 / 60) < 1e-12);
+
+    // By fraction the merge places 0.4 * 20 nodes, more than 0.6 * 10
+    auto [byFraction, fractionPenalty] = helper.freqFracBasedPredictions(frequencies, nodes, "frac");
+    assert(byFraction.size() == 5);
+    assert(std::find(byFraction.begin(), byFraction.end(), range(0, 20)) != byFraction.end());
+    assert(std::abs(fractionPenalty - 20 * 0.6 / 60) < 1e-12);
+
+    auto best = helper.findPenaltyForEachNode(frequencies, nodes);
+    assert(std::abs(best[5] - 0.4) < 1e-12 && best[25] == 0.0);
+    auto penalties = helper.computeStructurePenalty({range(0, 5), range(20, 30)}, frequencies, {0, 25, 40});
+    assert(penalties[0] == 1.0 && penalties[1] == 0.0 && penalties[2] == 1.0);
+
+    bool threw = false;
+    try {
+        helper.freqFracBasedPredictions(frequencies, nodes, "mean");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Consensus communities test passed!" << std::endl;
+}
+
+// Test the file driven pipeline with string nodes
+void testFreqFracCommunities() {
+    std::cout << "Testing FreqFracCommunities..." << std::endl;
+
+    FreqFracCommunities<std::string> consensus("freqfrac_original.txt", ".", GENERATED_FILES, "freqfrac_groups", 2);
+    assert(consensus.getOriginalNetworkNodes().size() == 60);
+    assert(consensus.getNetworksGroupsDict().size() == 7);
+    consensus.processCommunities("freqfrac_out");
+
+    FreqFracHelper<std::string> helper;
+    auto written = helper.readNetworkGroups("freqfrac_out_frac.txt", consensus.getOriginalNetworkNodes());
+    assert(written == consensus.generateFractionBasedCommunities().first);
+    std::ifstream scoreFile("freqfrac_out_freq_score.txt");
+    double score = -1;
+    scoreFile >> score;
+    assert(std::abs(score - consensus.generateFrequencyBasedCommunities().second) < 1e-6);
+
+    bool threw = false;
+    try {
+        FreqFracCommunities<std::string> missing("freqfrac_original.txt", ".", GENERATED_FILES + 1, "freqfrac_groups");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "FreqFracCommunities test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FreqFracCommunities tests..." << std::endl;
+
+    writeTestFiles();
+    testCountNetworkGroups();
+    testConsensus();
+    testFreqFracCommunities();
+    removeTestFiles();
+
+    std::cout << "All FreqFracCommunities tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,422 @@
+#include "../CLASSES/Graph2/Graph2.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <tuple>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+
+// Performance benchmarks for Graph2. Sizes can be overridden from the command line:
+//     graph2_benchmark [numVertices] [numEdges]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Write a random graph in the Graph2 text format (see Graph::saveToFile)
+void writeRandomGraphFile(const std::string& filename, size_t numVertices, size_t numEdges, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> pickVertex(0, numVertices - 1);
+    std::uniform_real_distribution<double> pickWeight(0.1, 10.0);
+
+    std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+    seen.reserve(numEdges);
+
+    std::ofstream file(filename);
+    file << numVertices << "\n";
+    for (size_t v = 0; v < numVertices; ++v) {
+        file << v << " ";
+    }
+    file << "\n" << numEdges << "\n";
+    while (seen.size() < numEdges) {
+        size_t from = pickVertex(rng);
+        size_t to = pickVertex(rng);
+        if (from == to || !seen.insert(std::minmax(from, to)).second) {
+            continue;
+        }
+        file << from << " " << to << " " << pickWeight(rng) << "\n";
+    }
+}
+
+// Current getline + stringstream constructor vs the chunked bulk loader
+void benchmarkFileLoading(size_t numVertices, size_t numEdges) {
+    std::cout << "File loading (" << numVertices << " vertices, " << numEdges << " edges)" << std::endl;
+    const std::string filename = "graph2_benchmark_graph.txt";
+    writeRandomGraphFile(filename, numVertices, numEdges, 42);
+
+    auto start = Clock::now();
+    Graph<int> constructed(filename);
+    double constructorSeconds = secondsSince(start);
+
+    start = Clock::now();
+    Graph<int> bulk = Graph<int>::loadBulk(filename);
+    double bulkSeconds = secondsSince(start);
+
+    assert(bulk.getVertexCount() == constructed.getVertexCount());
+    assert(bulk.getEdgeCount() == constructed.getEdgeCount());
+
+    // Parsing on every hardware thread, into the graph and straight to CSR
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    start = Clock::now();
+    Graph<int> parallel = Graph<int>::loadBulk(filename, threads);
+    double parallelSeconds = secondsSince(start);
+    assert(parallel.getEdgeCount() == bulk.getEdgeCount());
+
+    start = Clock::now();
+    CsrGraph<int> frozen = bulk.freeze();
+    double freezeSeconds = secondsSince(start);
+
+    start = Clock::now();
+    CsrGraph<int> csr = Graph<int>::loadCsr(filename, threads);
+    double csrSeconds = secondsSince(start);
+    assert(csr.getEntryCount() == frozen.getEntryCount());
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "  Graph(filename):     " << constructorSeconds << " s ("
+              << numEdges / constructorSeconds / 1e6 << " M edges/s)" << std::endl
+              << "  Graph::loadBulk:     " << bulkSeconds << " s ("
+              << numEdges / bulkSeconds / 1e6 << " M edges/s)" << std::endl
+              << "  speedup:             " << constructorSeconds / bulkSeconds << "x" << std::endl
+              << "  loadBulk, " << threads << " threads: " << parallelSeconds << " s ("
+              << numEdges / parallelSeconds / 1e6 << " M edges/s)" << std::endl
+              << "  loadBulk + freeze:   " << bulkSeconds + freezeSeconds << " s" << std::endl
+              << "  loadCsr, " << threads << " threads:  " << csrSeconds << " s ("
+              << numEdges / csrSeconds / 1e6 << " M edges/s)" << std::endl;
+
+    std::remove(filename.c_str());
+}
+
+// Text reload vs memory mapping the binary CSR format
+void benchmarkBinaryFormat(size_t numVertices, size_t numEdges) {
+    std::cout << "Binary CSR format (" << numVertices << " vertices, " << numEdges << " edges)" << std::endl;
+    const std::string textFile = "graph2_benchmark_graph.txt";
+    const std::string binaryFile = "graph2_benchmark_graph.csr";
+    writeRandomGraphFile(textFile, numVertices, numEdges, 7);
+
+    Graph<int> graph = Graph<int>::loadBulk(textFile);
+    auto start = Clock::now();
+    graph.saveToBinaryFile(binaryFile);
+    double saveSeconds = secondsSince(start);
+
+    start = Clock::now();
+    Graph<int> reloaded = Graph<int>::loadBulk(textFile);
+    double textSeconds = secondsSince(start);
+
+    start = Clock::now();
+    CsrGraph<int> mapped = CsrGraph<int>::loadBinary(binaryFile);
+    double mapSeconds = secondsSince(start);
+
+    // first full scan pages the mapping in
+    start = Clock::now();
+    double weightSum = 0;
+    for (uint32_t id = 0; id < mapped.getVertexCount(); ++id) {
+        CsrNeighborRange range = mapped.neighbors(id);
+        for (size_t i = 0; i < range.size(); ++i) {
+            weightSum += range.weight(i);
+        }
+    }
+    double scanSeconds = secondsSince(start);
+    assert(std::abs(weightSum / 2 - reloaded.getTotalWeight()) < 1e-6 * weightSum);
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "  saveToBinaryFile:        " << saveSeconds << " s" << std::endl
+              << "  loadBulk (text):         " << textSeconds << " s" << std::endl
+              << "  CsrGraph::loadBinary:    " << mapSeconds << " s" << std::endl
+              << "  first scan of mapping:   " << scanSeconds << " s" << std::endl;
+
+    std::remove(textFile.c_str());
+    std::remove(binaryFile.c_str());
+}
+
+// Modularity of a round-robin partition through each entry point
+void benchmarkModularity(size_t numVertices, size_t numEdges, int numCommunities) {
+    std::cout << "Modularity (" << numVertices << " vertices, " << numEdges << " edges, "
+              << numCommunities << " communities)" << std::endl;
+    const std::string filename = "graph2_benchmark_graph.txt";
+    writeRandomGraphFile(filename, numVertices, numEdges, 11);
+    Graph<int> graph = Graph<int>::loadBulk(filename);
+    std::remove(filename.c_str());
+    CsrGraph<int> csr = graph.freeze();
+
+    std::vector<Community<int>> communities(numCommunities);
+    std::unordered_map<int, int> nodeToCommunity;
+    std::vector<int> labels(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) {
+        int label = static_cast<int>(v % numCommunities);
+        communities[label].addNode(static_cast<int>(v));
+        nodeToCommunity[static_cast<int>(v)] = label;
+        labels[csr.getId(static_cast<int>(v))] = label;
+    }
+
+    auto start = Clock::now();
+    double fromCommunities = graph.calculateModularity(communities);
+    double communitySeconds = secondsSince(start);
+
+    start = Clock::now();
+    double fromMap = graph.calculateModularity(nodeToCommunity);
+    double mapSeconds = secondsSince(start);
+
+    start = Clock::now();
+    double fromCsr = csr.calculateModularity(labels);
+    double csrSeconds = secondsSince(start);
+
+    assert(std::abs(fromCommunities - fromMap) < 1e-9 && std::abs(fromMap - fromCsr) < 1e-9);
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "  Graph, vector<Community>:      " << communitySeconds << " s" << std::endl
+              << "  Graph, node -> label map:      " << mapSeconds << " s" << std::endl
+              << "  CsrGraph, label array:         " << csrSeconds << " s" << std::endl;
+}
+
+// Pruning the low-degree vertices one at a time vs in one removeVertices
+// call. One endpoint of every edge is drawn with density ~ x^(-2/3), which
+// gives hubs with tens of thousands of neighbors, most of them pruned.
+void benchmarkVertexRemoval(size_t numVertices, size_t numEdges) {
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<int> vertices(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) {
+        vertices[v] = static_cast<int>(v);
+    }
+    std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+    std::vector<Graph<int>::BulkEdge> edges;
+    while (edges.size() < numEdges) {
+        size_t from = rng() % numVertices;
+        size_t to = static_cast<size_t>(numVertices * std::pow(unit(rng), 3));
+        if (from == to || !seen.insert(std::minmax(from, to)).second) {
+            continue;
+        }
+        edges.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(to), 1.0});
+    }
+    Graph<int> graph = Graph<int>::buildBulk(vertices, edges);
+
+    // degree at most 3/4 of the average
+    std::set<int> lowDegree;
+    for (int v : graph.getVertices()) {
+        if (graph.getDegree(v) * 4 <= static_cast<int>(6 * numEdges / numVertices)) {
+            lowDegree.insert(v);
+        }
+    }
+    std::cout << "Vertex removal (" << numVertices << " vertices, " << numEdges << " edges, "
+              << lowDegree.size() << " removed)" << std::endl;
+
+    Graph<int> sequential = graph;
+    auto start = Clock::now();
+    for (int v : lowDegree) {
+        sequential.removeVertex(v);
+    }
+    double sequentialSeconds = secondsSince(start);
+
+    Graph<int> bulk = graph;
+    start = Clock::now();
+    bulk.removeVertices(lowDegree);
+    double bulkSeconds = secondsSince(start);
+    assert(bulk.getEdgeCount() == sequential.getEdgeCount());
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "  removeVertex per vertex:  " << sequentialSeconds << " s" << std::endl
+              << "  removeVertices:           " << bulkSeconds << " s" << std::endl;
+}
+
+// Half of the edges deleted and as many new edges inserted, one
+// removeEdge/addEdge call per update against one applyBatch. With skewed set,
+// one endpoint of every edge is drawn as in benchmarkVertexRemoval, so a few
+// hubs carry most of the updates.
+void benchmarkBatchUpdates(size_t numVertices, size_t numEdges, bool skewed) {
+    std::mt19937_64 rng(9);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_real_distribution<double> pickWeight(0.1, 10.0);
+    std::vector<int> vertices(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) {
+        vertices[v] = static_cast<int>(v);
+    }
+    std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+    seen.reserve(2 * numEdges);
+    auto randomEdge = [&]() {
+        while (true) {
+            size_t from = rng() % numVertices;
+            size_t to = skewed ? static_cast<size_t>(numVertices * std::pow(unit(rng), 3)) : rng() % numVertices;
+            if (from != to && seen.insert(std::minmax(from, to)).second) {
+                return std::make_pair(from, to);
+            }
+        }
+    };
+    std::vector<Graph<int>::BulkEdge> edges;
+    edges.reserve(numEdges);
+    for (size_t i = 0; i < numEdges; ++i) {
+        auto [from, to] = randomEdge();
+        edges.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(to), pickWeight(rng)});
+    }
+    Graph<int> graph = Graph<int>::buildBulk(vertices, edges);
+
+    std::shuffle(edges.begin(), edges.end(), rng);
+    std::vector<std::pair<int, int>> deletes;
+    std::vector<std::tuple<int, int, double>> inserts;
+    for (size_t i = 0; i < numEdges / 2; ++i) {
+        deletes.emplace_back(edges[i].from, edges[i].to);
+        auto [from, to] = randomEdge();
+        inserts.emplace_back(static_cast<int>(from), static_cast<int>(to), pickWeight(rng));
+    }
+    size_t updates = deletes.size() + inserts.size();
+    std::cout << "Batched edge updates, " << (skewed ? "skewed" : "uniform") << " (" << numVertices << " vertices, " << numEdges << " edges, "
+              << deletes.size() << " deletes, " << inserts.size() << " inserts)" << std::endl;
+
+    Graph<int> sequential = graph;
+    auto start = Clock::now();
+    for (const auto& [from, to] : deletes) {
+        sequential.removeEdge(from, to);
+    }
+    for (const auto& [from, to, weight] : inserts) {
+        sequential.addEdge(from, to, weight);
+    }
+    double sequentialSeconds = secondsSince(start);
+
+    Graph<int> batch = graph;
+    start = Clock::now();
+    batch.applyBatch(inserts, deletes);
+    double batchSeconds = secondsSince(start);
+    assert(batch.getEdgeCount() == sequential.getEdgeCount());
+    assert(std::abs(batch.getTotalWeight() - sequential.getTotalWeight()) < 1e-6 * numEdges);
+
+    std::cout << std::fixed << std::setprecision(4)
+              << "  removeEdge/addEdge: " << sequentialSeconds << " s, "
+              << std::setprecision(2) << updates / sequentialSeconds / 1e6 << " M updates/s" << std::endl
+              << std::setprecision(4)
+              << "  applyBatch:         " << batchSeconds << " s, "
+              << std::setprecision(2) << updates / batchSeconds / 1e6 << " M updates/s" << std::endl;
+}
+
+// The pair hash Graph2 used before PairHash mixed its output
+struct ShiftXorPairHash {
+    size_t operator()(const std::pair<int, int>& p) const {
+        return std::hash<int>{}(p.first) ^ (std::hash<int>{}(p.second) << 1);
+    }
+};
+
+// Nanoseconds per lookup of every key, summing the weights found
+template <typename Lookup>
+double nanosPerLookup(const std::vector<std::pair<int, int>>& keys, Lookup lookup) {
+    double sum = 0;
+    auto start = Clock::now();
+    for (const auto& key : keys) {
+        sum += lookup(key);
+    }
+    double seconds = secondsSince(start);
+    assert(sum >= 0);
+    return seconds / keys.size() * 1e9;
+}
+
+// hasEdge / getEdgeWeight latency, and the edge index alone against
+// std::unordered_map with the old and the new pair hash, on three layouts:
+//   "grid"        ids 0..n-1 in a square grid, edges to the right and below
+//   "sequential"  ids 0..n-1, numEdges random edges (the loader benchmarks)
+//   "random"      ids spread over the whole int range, numEdges random edges
+void benchmarkEdgeLookup(size_t numVertices, size_t numEdges, const std::string& layout) {
+    std::mt19937_64 rng(23);
+    std::vector<int> ids(numVertices);
+    std::vector<std::pair<int, int>> edges;
+    if (layout == "grid") {
+        size_t width = static_cast<size_t>(std::sqrt(static_cast<double>(numVertices)));
+        numVertices = width * width;
+        ids.resize(numVertices);
+        for (size_t v = 0; v < numVertices; ++v) {
+            ids[v] = static_cast<int>(v);
+            if ((v + 1) % width != 0) edges.emplace_back(v, v + 1);
+            if (v + width < numVertices) edges.emplace_back(v, v + width);
+        }
+    } else {
+        std::unordered_set<int> used;
+        for (size_t v = 0; v < numVertices; ++v) {
+            int id = static_cast<int>(v);
+            if (layout == "random") {
+                do {
+                    id = static_cast<int>(rng() & 0x7FFFFFFF);
+                } while (!used.insert(id).second);
+            }
+            ids[v] = id;
+        }
+        std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+        while (edges.size() < numEdges) {
+            size_t from = rng() % numVertices;
+            size_t to = rng() % numVertices;
+            if (from != to && seen.insert(std::minmax(from, to)).second) {
+                edges.emplace_back(from, to);
+            }
+        }
+    }
+
+    std::vector<Graph<int>::BulkEdge> bulk;
+    for (const auto& [from, to] : edges) {
+        bulk.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(to), 1.0});
+    }
+    Graph<int> graph = Graph<int>::buildBulk(ids, bulk);
+    std::unordered_map<std::pair<int, int>, double, ShiftXorPairHash> shiftXor;
+    std::unordered_map<std::pair<int, int>, double, PairHash<int>> mixed;
+    shiftXor.reserve(edges.size());
+    mixed.reserve(edges.size());
+    for (const auto& [from, to] : edges) {
+        shiftXor.emplace(std::minmax(ids[from], ids[to]), 1.0);
+        mixed.emplace(std::minmax(ids[from], ids[to]), 1.0);
+    }
+
+    // Present edges in random order, and as many absent vertex pairs
+    std::vector<std::pair<int, int>> hits, misses;
+    for (const auto& [from, to] : edges) {
+        hits.emplace_back(std::minmax(ids[from], ids[to]));
+    }
+    std::shuffle(hits.begin(), hits.end(), rng);
+    while (misses.size() < hits.size()) {
+        int a = ids[rng() % numVertices];
+        int b = ids[rng() % numVertices];
+        if (a != b && !graph.hasEdge(a, b)) misses.emplace_back(std::minmax(a, b));
+    }
+
+    const auto& index = graph.getEdgesWithWeight();
+    double hasEdgeHit = nanosPerLookup(hits, [&](const std::pair<int, int>& k) { return graph.hasEdge(k.second, k.first); });
+    double hasEdgeMiss = nanosPerLookup(misses, [&](const std::pair<int, int>& k) { return graph.hasEdge(k.second, k.first); });
+    double weightHit = nanosPerLookup(hits, [&](const std::pair<int, int>& k) { return graph.getEdgeWeight(k.second, k.first); });
+    auto findIn = [](const auto& map) {
+        return [&map](const std::pair<int, int>& k) {
+            auto found = map.find(k);
+            return found == map.end() ? 0.0 : found->second;
+        };
+    };
+
+    std::cout << "Edge lookup, " << layout << " ids ("
+              << numVertices << " vertices, " << edges.size() << " edges), ns per call" << std::endl
+              << std::fixed << std::setprecision(1)
+              << "  hasEdge hit / miss:                 " << hasEdgeHit << " / " << hasEdgeMiss << std::endl
+              << "  getEdgeWeight:                      " << weightHit << std::endl
+              << "  FlatEdgeMap find hit / miss:        " << nanosPerLookup(hits, findIn(index))
+              << " / " << nanosPerLookup(misses, findIn(index)) << std::endl
+              << "  unordered_map, PairHash hit / miss: " << nanosPerLookup(hits, findIn(mixed))
+              << " / " << nanosPerLookup(misses, findIn(mixed)) << std::endl
+              << "  unordered_map, h1^(h2<<1) hit/miss: " << nanosPerLookup(hits, findIn(shiftXor))
+              << " / " << nanosPerLookup(misses, findIn(shiftXor)) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t numVertices = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t numEdges = argc > 2 ? std::stoul(argv[2]) : 2000000;
+
+    std::cout << "Running Graph2 benchmarks..." << std::endl;
+
+    benchmarkFileLoading(numVertices, numEdges);
+    benchmarkBinaryFormat(numVertices, numEdges);
+    benchmarkModularity(numVertices, numEdges, 10);
+    benchmarkModularity(numVertices, numEdges, 1000);
+    benchmarkVertexRemoval(numVertices, numEdges);
+    benchmarkBatchUpdates(numVertices, numEdges, false);
+    benchmarkBatchUpdates(numVertices, numEdges, true);
+    benchmarkEdgeLookup(numVertices, numEdges, "grid");
+    benchmarkEdgeLookup(numVertices, numEdges, "sequential");
+    benchmarkEdgeLookup(numVertices, numEdges, "random");
+
+    return 0;
+}
@@ -3,6 +3,11 @@
 #include <string>
 #include <cassert>
 #include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <tuple>
+#include <random>
+#include <unordered_map>
 
 // Utility function to create a simple test graph
 template <typename T>
@@ -118,6 +123,202 @@ void testFileIO() {
     std::cout << "File I/O test passed!" << std::endl;
 }
 
+// Test the chunked bulk loader against the regular file constructor
+void testBulkLoad() {
+    std::cout << "Testing bulk file loading..." << std::endl;
+    Graph<int> g = createTestGraph<int>();
+    g.addVertex(5); // isolated vertex
+    g.saveToFile("test_graph_bulk.txt");
+    
+    Graph<int> loadedGraph("test_graph_bulk.txt");
+    Graph<int> bulkGraph = Graph<int>::loadBulk("test_graph_bulk.txt");
+    
+    assert(bulkGraph.getVertexCount() == loadedGraph.getVertexCount());
+    assert(bulkGraph.getEdgeCount() == loadedGraph.getEdgeCount());
+    assert(bulkGraph.getTotalWeight() == loadedGraph.getTotalWeight());
+    for (const int& vertex : loadedGraph.getVertices()) {
+        assert(bulkGraph.hasVertex(vertex));
+        assert(bulkGraph.getDegree(vertex) == loadedGraph.getDegree(vertex));
+        assert(bulkGraph.getWeightedDegree(vertex) == loadedGraph.getWeightedDegree(vertex));
+    }
+    assert(bulkGraph.getEdgeWeight(4, 1) == 4.0);
+    
+    // Duplicate edges and unknown vertices are rejected like in the constructor
+    std::ofstream bad("test_graph_bulk.txt");
+    bad << "2\n1 2\n2\n1 2 1.0\n2 1 3.0\n";
+    bad.close();
+    bool threw = false;
+    try {
+        Graph<int>::loadBulk("test_graph_bulk.txt");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    bad.open("test_graph_bulk.txt");
+    bad << "2\r\n1 2\r\n1\r\n1 3 1.0\r\n";
+    bad.close();
+    threw = false;
+    try {
+        Graph<int>::loadBulk("test_graph_bulk.txt");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // String vertices work as well
+    std::ofstream names("test_graph_bulk.txt");
+    names << "3\nalice bob carol\n2\nalice bob 1.5\nbob carol 2.5";
+    names.close();
+    Graph<std::string> namedGraph = Graph<std::string>::loadBulk("test_graph_bulk.txt");
+    assert(namedGraph.getEdgeCount() == 2);
+    assert(namedGraph.getWeightedDegree("bob") == 4.0);
+    
+    std::remove("test_graph_bulk.txt");
+    
+    std::cout << "Bulk file loading test passed!" << std::endl;
+}
+
+// Test multi-threaded loading against the single-threaded loader
+void testParallelLoad() {
+    std::cout << "Testing parallel file loading..." << std::endl;
+
+    // Enough edges that every thread gets several lines, plus a self-loop
+    Graph<int> g;
+    for (int v = 0; v < 40; v++) {
+        g.addVertex(v);
+    }
+    for (int v = 0; v < 40; v++) {
+        g.addEdge(v, (v + 1) % 40, 1.0 + v % 3);
+        if (!g.hasEdge(v, (v * 7 + 3) % 40)) {
+            g.addEdge(v, (v * 7 + 3) % 40, 0.5);
+        }
+    }
+    g.addEdge(5, 5, 2.0);
+    g.saveToFile("test_graph_parallel.txt");
+    Graph<int> expected = Graph<int>::loadBulk("test_graph_parallel.txt");
+    CsrGraph<int> frozen = expected.freeze();
+
+    for (unsigned threads : {2u, 3u, 7u, 64u, 0u}) {
+        Graph<int> loaded = Graph<int>::loadBulk("test_graph_parallel.txt", threads);
+        assert(loaded.getEdgesWithWeight() == expected.getEdgesWithWeight());
+        for (const int& vertex : expected.getVertices()) {
+            assert(loaded.getNeighbors(vertex) == expected.getNeighbors(vertex));
+            assert(loaded.getWeightedDegree(vertex) == expected.getWeightedDegree(vertex));
+        }
+
+        // Straight to CSR gives the same snapshot as freeze()
+        CsrGraph<int> csr = Graph<int>::loadCsr("test_graph_parallel.txt", threads);
+        assert(csr.getVertexCount() == frozen.getVertexCount());
+        assert(csr.getEdgeCount() == frozen.getEdgeCount());
+        assert(csr.getTotalWeight() == frozen.getTotalWeight());
+        for (uint32_t id = 0; id < frozen.getVertexCount(); id++) {
+            assert(csr.getVertex(id) == frozen.getVertex(id));
+            assert(csr.getWeightedDegree(id) == frozen.getWeightedDegree(id));
+            CsrNeighborRange a = csr.neighbors(id), b = frozen.neighbors(id);
+            assert(a.size() == b.size());
+            for (size_t i = 0; i < a.size(); i++) {
+                assert(a.target(i) == b.target(i) && a.weight(i) == b.weight(i));
+            }
+        }
+    }
+
+    // Errors are the ones a single thread reports first, lines past the
+    // edge count are ignored
+    auto loadError = [](const std::string& contents, unsigned threads) -> std::string {
+        std::ofstream("test_graph_parallel.txt") << contents;
+        try {
+            Graph<int>::loadBulk("test_graph_parallel.txt", threads);
+        } catch (const std::exception& e) {
+            return e.what();
+        }
+        return "";
+    };
+    std::string lines = "1 2 1.0\n2 3 1.0\n3 4 1.0\n1 3 1.0\n1 4 1.0\n";
+    std::vector<std::string> inputs = {
+        "4\n1 2 3 4\n5\n" + lines + "x y z\n",
+        "4\n1 2 3 4\n6\n" + lines,
+        "4\n1 2 3 4\n5\n1 2 1.0\n2 3 1.0\n3 x 1.0\n1 9 1.0\n1 4 -1.0\n",
+        "4\n1 2 3 4\n5\n1 2 1.0\n2 9 1.0\n3 x 1.0\n1 3 1.0\n1 4 -1.0\n",
+        "4\n1 2 3 4\n5\n1 2 1.0\n2 3 1.0\n3 4 1.0\n1 3 1.0\n1 4 -1.0",
+        "4\n1 2 3 4\n5\n1 2 1.0\n2 3 1.0\n3 4 1.0\n1 3 1.0\n2 1 1.0\n",
+    };
+    for (const std::string& input : inputs) {
+        std::string single = loadError(input, 1);
+        assert(single != "" || input == inputs[0]);
+        for (unsigned threads : {2u, 3u, 5u, 16u}) {
+            assert(loadError(input, threads) == single);
+        }
+    }
+    assert(loadError(inputs[2], 3) == "Error parsing edge at line 6");
+
+    std::remove("test_graph_parallel.txt");
+
+    std::cout << "Parallel file loading test passed!" << std::endl;
+}
+
+// Test the open-addressing edge index against std::unordered_map
+void testFlatEdgeMap() {
+    std::cout << "Testing FlatEdgeMap..." << std::endl;
+
+    using Key = std::pair<int, int>;
+    FlatEdgeMap<Key, double, PairHash<int>> map;
+    assert(map.empty() && map.find({1, 2}) == map.end() && map.erase({1, 2}) == 0);
+    assert(map.try_emplace({1, 2}, 1.5).second);
+    assert(!map.try_emplace({1, 2}, 9.0).second && map.at({1, 2}) == 1.5);
+    map[{2, 3}] = 4.0;
+    assert(map.size() == 2 && map.find({2, 3})->second == 4.0);
+    bool threw = false;
+    try {
+        map.at({3, 4});
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Iterators survive erase and inserts within the reserved size
+    map.reserve(100);
+    auto kept = map.find({1, 2});
+    size_t capacity = map.capacity();
+    for (int i = 10; i < 108; i++) {
+        map.try_emplace({i, i + 1}, i);
+    }
+    map.erase(map.find({2, 3}));
+    assert(map.capacity() == capacity && kept->second == 1.5 && map.size() == 99);
+
+    // Random inserts, erases and re-inserts agree with unordered_map,
+    // including across rehashes and tombstone reuse
+    std::unordered_map<Key, double, PairHash<int>> expected(map.begin(), map.end());
+    std::mt19937 rng(5);
+    for (int step = 0; step < 20000; step++) {
+        Key key(rng() % 300, rng() % 300);
+        if (rng() % 3 == 0) {
+            assert(map.erase(key) == expected.erase(key));
+        } else {
+            double weight = rng() % 10;
+            assert(map.try_emplace(key, weight).second == expected.try_emplace(key, weight).second);
+        }
+    }
+    assert(map.size() == expected.size());
+    size_t visited = 0;
+    for (const auto& [key, weight] : map) {
+        assert(expected.at(key) == weight);
+        visited++;
+    }
+    assert(visited == expected.size());
+
+    // Equality ignores capacity and slot order
+    FlatEdgeMap<Key, double, PairHash<int>> copy;
+    for (const auto& [key, weight] : expected) {
+        copy.try_emplace(key, weight);
+    }
+    assert(copy == map);
+    copy.erase(expected.begin()->first);
+    assert(copy != map);
+
+    std::cout << "FlatEdgeMap test passed!" << std::endl;
+}
+
 // Test subgraph creation
 void testSubgraph() {
     std::cout << "Testing subgraph creation..." << std::endl;
@@ -159,6 +360,196 @@ void testModularity() {
     std::cout << "Modularity test passed!" << std::endl;
 }
 
+// Test the single-pass label based modularity against per-community scoring
+void testModularityLabels() {
+    std::cout << "Testing label based modularity..." << std::endl;
+    Graph<int> g = createTestGraph<int>();
+    g.addEdge(1, 3, 2.5);
+    g.addVertex(5); // isolated vertex in no community
+    
+    Community<int> community1;
+    community1.addNode(1);
+    community1.addNode(2);
+    Community<int> community2;
+    community2.addNode(3);
+    community2.addNode(4);
+    community2.addNode(99); // not in the graph, ignored
+    
+    // Q = [1/12.5 - (10.5/25)^2] + [3/12.5 - (14.5/25)^2]
+    double expected = 1.0 / 12.5 - std::pow(10.5 / 25.0, 2) + 3.0 / 12.5 - std::pow(14.5 / 25.0, 2);
+    double modularity = g.calculateModularity(std::vector<Community<int>>{community1, community2});
+    assert(std::abs(modularity - expected) < 1e-12);
+    
+    std::unordered_map<int, int> labels = {{1, 0}, {2, 0}, {3, 1}, {4, 1}, {5, -1}};
+    assert(std::abs(g.calculateModularity(labels) - expected) < 1e-12);
+    
+    // Everything in one community gives 0
+    std::unordered_map<int, int> single = {{1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}};
+    assert(std::abs(g.calculateModularity(single)) < 1e-12);
+    
+    // Overlapping communities are still scored community by community
+    Community<int> overlapping;
+    overlapping.addNode(2);
+    overlapping.addNode(3);
+    double overlapModularity = g.calculateModularity(std::vector<Community<int>>{community1, community2, overlapping});
+    // extra community {2,3}: L = 2, K = 3 + 7.5
+    assert(std::abs(overlapModularity - (expected + 2.0 / 12.5 - std::pow(10.5 / 25.0, 2))) < 1e-12);
+    
+    std::cout << "Label based modularity test passed!" << std::endl;
+}
+
+// Test that bulk vertex removal matches removing one vertex at a time
+void testRemoveVertices() {
+    std::cout << "Testing vertex removal..." << std::endl;
+    
+    // ring with chords, a self-loop on 0 and a removed-removed edge 3-6
+    Graph<int> original;
+    for (int v = 0; v < 30; v++) {
+        original.addEdge(v, (v + 1) % 30, 1.0 + v % 4);
+        if (v % 3 == 0) original.addEdge(v, (v + 7) % 30, 0.5);
+    }
+    original.addEdge(0, 0, 2.5);
+    original.addEdge(3, 6, 1.5);
+    std::set<int> toRemove = {0, 3, 6, 7, 20, 99};  // 99 is not in the graph
+    
+    Graph<int> sequential = original;
+    for (int v : toRemove) {
+        sequential.removeVertex(v);
+        assert(!sequential.hasVertex(v));
+    }
+    Graph<int> bulk = original;
+    bulk.removeVertices(toRemove);
+    
+    assert(bulk.getVertices() == sequential.getVertices());
+    assert(bulk.getVertexCount() == 25);
+    assert(bulk.getEdgeCount() == sequential.getEdgeCount());
+    assert(bulk.getEdgesWithWeight() == sequential.getEdgesWithWeight());
+    assert(std::abs(bulk.getTotalWeight() - sequential.getTotalWeight()) < 1e-9);
+    double remaining = 0;
+    for (const auto& [edge, weight] : bulk.getEdgesWithWeight()) remaining += weight;
+    assert(std::abs(bulk.getTotalWeight() - remaining) < 1e-9);
+    for (int v : bulk.getVertices()) {
+        assert(std::abs(bulk.getWeightedDegree(v) - sequential.getWeightedDegree(v)) < 1e-9);
+        auto bulkNeighbors = bulk.getNeighbors(v);
+        auto sequentialNeighbors = sequential.getNeighbors(v);
+        assert(bulkNeighbors == sequentialNeighbors);  // relative order is kept
+        for (const auto& [neighbor, weight] : bulkNeighbors) {
+            assert(!toRemove.count(neighbor) && bulk.getEdgeWeight(v, neighbor) == weight);
+        }
+    }
+    
+    // Removing a vertex updates its neighbors' degrees
+    Graph<int> g = createTestGraph<int>();
+    g.removeVertex(2);
+    assert(g.getDegree(1) == 1 && g.getDegree(3) == 1);
+    assert(g.getWeightedDegree(1) == 4.0 && g.getWeightedDegree(3) == 3.0);
+    assert(g.getTotalWeight() == 7.0 && !g.hasEdge(1, 2));
+    
+    std::cout << "Vertex removal test passed!" << std::endl;
+}
+
+// Test that a batch of updates matches removeEdge/addEdge calls in order
+void testApplyBatch() {
+    std::cout << "Testing batched edge updates..." << std::endl;
+    
+    // a hub 0 joined to every vertex, a ring and a self-loop on 5
+    Graph<int> original;
+    for (int v = 1; v < 40; v++) {
+        original.addEdge(0, v, 1.0 + v % 3);
+        original.addEdge(v, v % 39 + 1, 0.5);
+    }
+    original.addEdge(5, 5, 2.0);
+    
+    std::vector<std::pair<int, int>> deletes = {{5, 5}, {7, 8}, {12, 0}};
+    for (int v = 20; v < 40; v++) deletes.emplace_back(0, v);  // most of the hub
+    std::vector<std::tuple<int, int, double>> inserts = {
+        {7, 8, 4.0},    // re-inserted with a new weight
+        {5, 5, 1.0},    // self-loop
+        {50, 3, 2.5},   // new vertex
+        {50, 51, 0.0},  // two new vertices
+        {0, 21, 3.0}
+    };
+    for (int v = 1; v < 10; v++) inserts.emplace_back(v, v + 20, 0.25);
+    
+    Graph<int> sequential = original;
+    for (const auto& [from, to] : deletes) sequential.removeEdge(from, to);
+    for (const auto& [from, to, weight] : inserts) sequential.addEdge(from, to, weight);
+    Graph<int> batch = original;
+    batch.applyBatch(inserts, deletes);
+    
+    assert(batch.getVertices() == sequential.getVertices());
+    assert(batch.getEdgesWithWeight() == sequential.getEdgesWithWeight());
+    assert(std::abs(batch.getTotalWeight() - sequential.getTotalWeight()) < 1e-9);
+    for (int v : batch.getVertices()) {
+        assert(std::abs(batch.getWeightedDegree(v) - sequential.getWeightedDegree(v)) < 1e-9);
+        assert(batch.getNeighbors(v) == sequential.getNeighbors(v));  // same order too
+    }
+    assert(batch.getEdgeWeight(8, 7) == 4.0 && batch.getDegree(5) == 6);
+    
+    // Invalid batches throw before changing the graph
+    auto expectThrow = [&](const std::vector<std::tuple<int, int, double>>& badInserts,
+                           const std::vector<std::pair<int, int>>& badDeletes) {
+        Graph<int> g = original;
+        bool threw = false;
+        try {
+            g.applyBatch(badInserts, badDeletes);
+        } catch (const std::logic_error&) {
+            threw = true;
+        }
+        assert(threw);
+        assert(g.getEdgesWithWeight() == original.getEdgesWithWeight());
+        assert(g.getTotalWeight() == original.getTotalWeight() && !g.hasVertex(60));
+    };
+    expectThrow({{60, 1, 1.0}}, {{1, 3}});                 // missing edge
+    expectThrow({{60, 1, 1.0}}, {{7, 8}, {8, 7}});         // deleted twice
+    expectThrow({{60, 1, 1.0}, {0, 1, 1.0}}, {});          // existing edge
+    expectThrow({{60, 1, 1.0}, {1, 60, 2.0}}, {});         // inserted twice
+    expectThrow({{7, 8, 1.0}, {8, 7, 2.0}}, {{7, 8}});     // re-inserted twice
+    expectThrow({{60, 1, 1.0}, {60, 2, -1.0}}, {});        // negative weight
+    
+    std::cout << "Batched edge updates test passed!" << std::endl;
+}
+
+// Test the change events of a dynamic graph
+void testChangeListeners() {
+    std::cout << "Testing change listeners..." << std::endl;
+    
+    using Change = Graph<int>::Change;
+    using ChangeType = Graph<int>::ChangeType;
+    Graph<int> g;
+    std::vector<Change> changes;
+    size_t id = g.addChangeListener([&changes](const Change& change) { changes.push_back(change); });
+    
+    g.addEdge(1, 2, 1.5);
+    assert(changes.size() == 3);  // both vertices, then the edge
+    assert(changes[0].type == ChangeType::VertexAdded && changes[0].from == 1);
+    assert(changes[2].type == ChangeType::EdgeAdded && changes[2].weight == 1.5);
+    
+    g.addEdge(2, 2, 2.0);
+    g.addEdge(2, 3, 1.0);
+    changes.clear();
+    g.removeVertex(2);  // two edges and a self-loop, reported once each
+    assert(changes.size() == 4 && changes.back().type == ChangeType::VertexRemoved);
+    double removed = 0;
+    for (size_t i = 0; i < 3; i++) {
+        assert(changes[i].type == ChangeType::EdgeRemoved && changes[i].from == 2);
+        removed += changes[i].weight;
+    }
+    assert(removed == 4.5);
+    
+    // Copies start without listeners
+    Graph<int> copy = g;
+    changes.clear();
+    copy.addEdge(1, 3, 1.0);
+    assert(changes.empty());
+    
+    g.removeChangeListener(id);
+    g.addEdge(1, 3, 1.0);
+    assert(changes.empty());
+    
+    std::cout << "Change listeners test passed!" << std::endl;
+}
+
 int main() {
     std::cout << "Running Graph2 tests..." << std::endl;
     
@@ -166,8 +557,15 @@ int main() {
     testEdgeOperations();
     testDegreeOperations();
     testFileIO();
+    testBulkLoad();
+    testParallelLoad();
+    testFlatEdgeMap();
     testSubgraph();
     testModularity();
+    testModularityLabels();
+    testRemoveVertices();
+    testApplyBatch();
+    testChangeListeners();
     
     std::cout << "All Graph2 tests passed!" << std::endl;
     return 0;
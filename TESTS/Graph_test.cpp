@@ -0,0 +1,100 @@
+#include "../CLASSES/Graph/Graph.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
+
+// Loads filename with the given constructor arguments and returns what it
+// printed about invalid lines
+template <typename... Args>
+std::string loadCapturingOutput(Graph<int>& g, const std::string& filename, Args... args) {
+    std::ostringstream captured;
+    std::streambuf* previous = std::cout.rdbuf(captured.rdbuf());
+    g = Graph<int>(filename, args...);
+    std::cout.rdbuf(previous);
+    return captured.str();
+}
+
+// Same vertices, and for each one the same neighbors with the same weights
+bool sameGraph(const Graph<int>& a, const Graph<int>& b) {
+    std::vector<int> vertices = a.getVertices();
+    std::vector<int> others = b.getVertices();
+    std::sort(vertices.begin(), vertices.end());
+    std::sort(others.begin(), others.end());
+    if (vertices != others || a.getEdgeCount() != b.getEdgeCount()) {
+        return false;
+    }
+    for (int vertex : vertices) {
+        std::vector<std::pair<int, int>> neighbors = a.getNeighbors(vertex);
+        std::vector<std::pair<int, int>> otherNeighbors = b.getNeighbors(vertex);
+        std::sort(neighbors.begin(), neighbors.end());
+        std::sort(otherNeighbors.begin(), otherNeighbors.end());
+        if (neighbors != otherNeighbors) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test the chunked constructor against the line by line one
+void testParallelLoad() {
+    std::cout << "Testing parallel file loading..." << std::endl;
+
+    std::ifstream original("TESTS/test_data.txt");
+    assert(original.is_open());
+    std::string contents((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+
+    // test_data.txt, then an invalid line, a weight cut to its integer part,
+    // a duplicate edge and a final line without a newline
+    const std::string filename = "graph_test_data.txt";
+    {
+        std::ofstream file(filename);
+        file << contents << "\n"
+             << "5 six 1\n"
+             << "5 6 2.5\n"
+             << "6 5 9\n"
+             << "\n"
+             << "7 7 3";
+    }
+
+    for (const std::string& file : {std::string("TESTS/test_data.txt"), filename}) {
+        Graph<int> expected;
+        std::string expectedOutput = loadCapturingOutput(expected, file);
+        for (unsigned threads : {1u, 2u, 3u, 8u, 0u}) {
+            Graph<int> loaded;
+            std::string output = loadCapturingOutput(loaded, file, threads);
+            assert(sameGraph(loaded, expected));
+            assert(output == expectedOutput);
+        }
+    }
+
+    Graph<int> extended;
+    std::string output = loadCapturingOutput(extended, filename, 2u);
+    assert(extended.getEdgeWeight(5, 6) == 2);
+    assert(extended.getEdgeWeight(1, 2) == 3);   // from the "1 2 3 4" vertex line
+    assert(extended.hasEdge(7, 7));
+    assert(output.find("INVALID LINE FORMAT -> 5 six 1") != std::string::npos);
+
+    bool threw = false;
+    try {
+        Graph<int> missing("no_such_graph_file.txt", 2u);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::remove(filename.c_str());
+    std::cout << "Parallel file loading test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Graph tests..." << std::endl;
+
+    testParallelLoad();
+
+    std::cout << "All Graph tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "../CLASSES/IncrementalCommunityMaintainer/IncrementalCommunityMaintainer.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <unordered_set>
+
+// Cost of keeping a partition's scores current through a stream of edge
+// updates, against rescoring it from scratch. Sizes can be overridden:
+//     incremental_community_maintainer_benchmark [numVertices] [numEdges] [numUpdates]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Update {
+    bool insert;
+    int from;
+    int to;
+    double weight;
+};
+
+void applyUpdates(Graph<int>& graph, const std::vector<Update>& updates) {
+    for (const Update& update : updates) {
+        if (update.insert) {
+            graph.addEdge(update.from, update.to, update.weight);
+        } else {
+            graph.removeEdge(update.from, update.to);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t numVertices = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t numEdges = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    size_t numUpdates = argc > 3 ? std::stoul(argv[3]) : 200000;
+
+    std::cout << "Running IncrementalCommunityMaintainer benchmarks..." << std::endl;
+
+    // Random graph, communities of 100 consecutive vertices
+    std::mt19937_64 rng(17);
+    std::uniform_real_distribution<double> pickWeight(0.1, 10.0);
+    std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+    auto randomEdge = [&]() {
+        while (true) {
+            size_t from = rng() % numVertices;
+            size_t to = rng() % numVertices;
+            if (from != to && seen.insert(std::minmax(from, to)).second) {
+                return std::make_pair(static_cast<int>(from), static_cast<int>(to));
+            }
+        }
+    };
+    std::vector<int> vertices(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) {
+        vertices[v] = static_cast<int>(v);
+    }
+    std::vector<Graph<int>::BulkEdge> edges;
+    edges.reserve(numEdges);
+    for (size_t i = 0; i < numEdges; ++i) {
+        auto [from, to] = randomEdge();
+        edges.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(to), pickWeight(rng)});
+    }
+    Graph<int> original = Graph<int>::buildBulk(vertices, edges);
+    std::vector<Community<int>> communities((numVertices + 99) / 100);
+    for (size_t v = 0; v < numVertices; ++v) {
+        communities[v / 100].addNode(static_cast<int>(v));
+    }
+
+    // Alternating removals of existing edges and insertions of new ones
+    std::shuffle(edges.begin(), edges.end(), rng);
+    std::vector<Update> updates;
+    for (size_t i = 0; i < numUpdates; ++i) {
+        if (i % 2 == 0) {
+            updates.push_back({false, static_cast<int>(edges[i / 2].from), static_cast<int>(edges[i / 2].to), 0.0});
+        } else {
+            auto [from, to] = randomEdge();
+            updates.push_back({true, from, to, pickWeight(rng)});
+        }
+    }
+    std::cout << "Edge update stream (" << numVertices << " vertices, " << numEdges << " edges, "
+              << communities.size() << " communities, " << numUpdates << " updates)" << std::endl;
+
+    Graph<int> plain = original;
+    auto start = Clock::now();
+    applyUpdates(plain, updates);
+    double plainSeconds = secondsSince(start);
+
+    auto graph = std::make_shared<Graph<int>>(original);
+    start = Clock::now();
+    IncrementalCommunityMaintainer<int> maintainer(graph, communities);
+    double bindSeconds = secondsSince(start);
+    start = Clock::now();
+    applyUpdates(*graph, updates);
+    double maintainedSeconds = secondsSince(start);
+
+    start = Clock::now();
+    std::vector<Community<int>> rescored = maintainer.getCommunities();
+    double modularity = graph->calculateModularity(rescored);
+    Community<int>::calculateWeights(rescored, graph);
+    double rescoreSeconds = secondsSince(start);
+    assert(std::abs(modularity - maintainer.getModularity()) < 1e-9);
+
+    double perUpdate = (maintainedSeconds - plainSeconds) / numUpdates;
+    std::cout << std::fixed << std::setprecision(4)
+              << "  updates, no listener:      " << plainSeconds << " s" << std::endl
+              << "  updates, maintained:       " << maintainedSeconds << " s ("
+              << std::setprecision(3) << perUpdate * 1e6 << " us per update)" << std::endl
+              << std::setprecision(4)
+              << "  maintainer construction:   " << bindSeconds << " s" << std::endl
+              << "  rescore from scratch:      " << rescoreSeconds << " s" << std::endl;
+
+    return 0;
+}
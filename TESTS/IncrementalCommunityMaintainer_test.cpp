@@ -0,0 +1,212 @@
+#include "../CLASSES/IncrementalCommunityMaintainer/IncrementalCommunityMaintainer.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <tuple>
+
+// Tolerance of the maintained sums against a rescore from scratch
+const double EPSILON = 1e-9;
+
+// A graph that is built while a maintainer listens. The maintainer is bound
+// to vertices 1-8 before any edge exists; moves put 1-3 in community 0 and
+// 4-6 in community 1, while 7 and 8 stay without a community. Every edge
+// then arrives as an EdgeAdded event: two weighted triangles joined by 3-4,
+// a self-loop on 6 and an edge from 3 to the unassigned 7.
+struct GrowingGraph {
+    std::shared_ptr<Graph<int>> graph = std::make_shared<Graph<int>>();
+    std::unique_ptr<IncrementalCommunityMaintainer<int>> maintainer;
+
+    GrowingGraph() {
+        for (int v = 1; v <= 8; v++) {
+            graph->addVertex(v);
+        }
+        maintainer = std::make_unique<IncrementalCommunityMaintainer<int>>(graph, std::vector<Community<int>>());
+        for (int v = 1; v <= 6; v++) {
+            maintainer->moveNode(v, (v - 1) / 3);
+        }
+        graph->addEdge(1, 2, 1.0);
+        graph->addEdge(2, 3, 2.0);
+        graph->addEdge(1, 3, 1.5);
+        graph->addEdge(4, 5, 1.0);
+        graph->addEdge(5, 6, 1.0);
+        graph->addEdge(4, 6, 2.5);
+        graph->addEdge(3, 4, 0.5);
+        graph->addEdge(6, 6, 1.0);
+        graph->addEdge(3, 7, 1.0);
+    }
+};
+
+// The maintained scores equal a rescore of the current graph from scratch
+void assertCurrent(const IncrementalCommunityMaintainer<int>& maintainer, std::shared_ptr<Graph<int>>& g) {
+    std::vector<Community<int>> fresh = maintainer.getCommunities();
+    assert(std::abs(maintainer.getModularity() - g->calculateModularity(fresh)) < EPSILON);
+    Community<int>::calculateWeights(fresh, g);
+    for (size_t c = 0; c < fresh.size(); c++) {
+        const Community<int>& kept = maintainer.getCommunities()[c];
+        assert(kept == fresh[c] && kept.weightsCurrent());
+        assert(std::abs(kept.getInternalWeight() - fresh[c].getInternalWeight()) < EPSILON);
+        assert(std::abs(kept.getExternalWeight() - fresh[c].getExternalWeight()) < EPSILON);
+    }
+}
+
+// Test scores built from events, then single graph changes
+void testGraphChanges() {
+    std::cout << "Testing maintained scores under graph changes..." << std::endl;
+    GrowingGraph fixture;
+    auto& g = fixture.graph;
+    auto& maintainer = *fixture.maintainer;
+
+    // Scores built edge by edge equal those of binding to the finished graph
+    assertCurrent(maintainer, g);
+    assert(std::abs(maintainer.getInternalWeight(0) - 4.5) < EPSILON);
+    assert(maintainer.getCommunity(7) == -1 && maintainer.getCommunity(8) == -1);
+    IncrementalCommunityMaintainer<int> bound(g, maintainer.getCommunities());
+    assert(std::abs(bound.getModularity() - maintainer.getModularity()) < EPSILON);
+
+    g->addEdge(2, 5, 3.0);       // between communities
+    assertCurrent(maintainer, g);
+    g->addEdge(1, 1, 2.0);       // self-loop
+    assertCurrent(maintainer, g);
+    g->addEdge(7, 9, 1.0);       // new vertex, both ends without a community
+    assert(maintainer.getCommunity(9) == -1);
+    assertCurrent(maintainer, g);
+    g->removeEdge(4, 6);
+    assertCurrent(maintainer, g);
+    g->removeVertex(6);          // with its self-loop
+    assert(maintainer.getCommunity(6) == -1 && !maintainer.getCommunities()[1].containsNode(6));
+    assertCurrent(maintainer, g);
+    g->removeVertex(8);          // isolated and without a community
+    assertCurrent(maintainer, g);
+    g->removeVertices({1, 7});
+    assertCurrent(maintainer, g);
+    g->applyBatch({{2, 9, 1.0}, {4, 5, 4.0}, {2, 2, 0.5}}, {{4, 5}, {2, 5}});
+    assertCurrent(maintainer, g);
+
+    // Copies of the maintained communities merge without a recalculation
+    std::vector<Community<int>> kept = maintainer.getCommunities();
+    kept[0].merge(kept[1]);
+    Community<int> merged = kept[0];
+    merged.calculateWeights(g);
+    assert(std::abs(kept[0].getInternalWeight() - merged.getInternalWeight()) < EPSILON);
+    assert(std::abs(kept[0].getExternalWeight() - merged.getExternalWeight()) < EPSILON);
+
+    // Overlapping communities and unknown vertices are rejected
+    std::vector<Community<int>> partition(2);
+    partition[0].addNode(2);
+    partition[0].addNode(3);
+    partition[1].addNode(3);
+    bool threw = false;
+    try {
+        IncrementalCommunityMaintainer<int> overlapping(g, partition);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    partition[1] = Community<int>();
+    partition[1].addNode(42);
+    threw = false;
+    try {
+        IncrementalCommunityMaintainer<int> unknown(g, partition);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Maintained scores under graph changes test passed!" << std::endl;
+}
+
+// Test moving nodes, including into new communities and out of all of them
+void testMoves() {
+    std::cout << "Testing maintained node moves..." << std::endl;
+    GrowingGraph fixture;
+    auto& g = fixture.graph;
+    auto& maintainer = *fixture.maintainer;
+
+    double before = maintainer.getModularity();
+    double delta = maintainer.moveNode(3, 1);
+    assert(std::abs(maintainer.getModularity() - (before + delta)) < EPSILON);
+    assertCurrent(maintainer, g);
+    maintainer.moveNode(6, 3);   // opens communities 2 and 3, moves the self-loop
+    assert(maintainer.getCommunityCount() == 4 && maintainer.getCommunity(6) == 3);
+    assertCurrent(maintainer, g);
+    maintainer.moveNode(7, 0);   // an unassigned node joins
+    assertCurrent(maintainer, g);
+    maintainer.moveNode(1, -1);
+    assert(maintainer.getCommunity(1) == -1);
+    assertCurrent(maintainer, g);
+    assert(maintainer.moveNode(2, 0) == 0.0);
+    assert(maintainer.moveNode(8, -1) == 0.0);
+
+    bool threw = false;
+    try {
+        maintainer.moveNode(42, 0);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Maintained node moves test passed!" << std::endl;
+}
+
+// Test a long random stream of changes and moves against rescoring
+void testRandomStream() {
+    std::cout << "Testing a random stream of changes..." << std::endl;
+    std::mt19937 rng(11);
+    auto g = std::make_shared<Graph<int>>();
+    for (int v = 0; v < 60; v++) {
+        g->addEdge(v, (v + 1) % 60, 1.0);
+    }
+    std::vector<Community<int>> groups(6);
+    for (int v = 0; v < 60; v++) {
+        groups[v / 10].addNode(v);
+    }
+    auto maintainer = std::make_unique<IncrementalCommunityMaintainer<int>>(g, groups);
+
+    for (int step = 0; step < 2000; step++) {
+        int a = rng() % 70;
+        int b = rng() % 70;
+        switch (rng() % 5) {
+            case 0:
+            case 1:
+                if (!g->hasEdge(a, b)) g->addEdge(a, b, 0.5 + rng() % 4);
+                break;
+            case 2:
+                if (g->hasEdge(a, b)) g->removeEdge(a, b);
+                break;
+            case 3:
+                if (step % 10 == 0) g->removeVertex(a);
+                break;
+            case 4:
+                if (g->hasVertex(a)) maintainer->moveNode(a, static_cast<int>(rng() % 8) - 1);
+                break;
+        }
+        if (step % 50 == 0) {
+            assertCurrent(*maintainer, g);
+        }
+    }
+    assertCurrent(*maintainer, g);
+    double modularity = maintainer->getModularity();
+    maintainer->recompute();
+    assert(std::abs(maintainer->getModularity() - modularity) < EPSILON);
+
+    // A destroyed maintainer no longer listens
+    maintainer.reset();
+    g->addEdge(100, 101, 1.0);
+
+    std::cout << "Random stream of changes test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running IncrementalCommunityMaintainer tests..." << std::endl;
+
+    testGraphChanges();
+    testMoves();
+    testRandomStream();
+
+    std::cout << "All IncrementalCommunityMaintainer tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "../CLASSES/LabelPropagation/LabelPropagation.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <random>
+
+// Two 5-cliques joined by a single edge
+std::shared_ptr<Graph<int>> createTwoCliqueGraph() {
+    auto g = std::make_shared<Graph<int>>();
+    for (int i = 1; i <= 5; i++) {
+        for (int j = i + 1; j <= 5; j++) {
+            g->addEdge(i, j, 1.0);
+            g->addEdge(i + 5, j + 5, 1.0);
+        }
+    }
+    g->addEdge(5, 6, 1.0);
+    return g;
+}
+
+// Random graph with 20 planted groups of 50 vertices
+std::shared_ptr<Graph<int>> createPlantedGraph(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> inGroup(0, 49);
+    std::uniform_int_distribution<int> anyVertex(0, 999);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    auto g = std::make_shared<Graph<int>>();
+    for (int v = 0; v < 1000; v++) {
+        g->addVertex(v);
+    }
+    for (int v = 0; v < 1000; v++) {
+        for (int k = 0; k < 6; k++) {
+            int u = coin(rng) < 0.1 ? anyVertex(rng) : (v / 50) * 50 + inGroup(rng);
+            if (u != v && !g->hasEdge(u, v)) {
+                g->addEdge(u, v, 1.0);
+            }
+        }
+    }
+    return g;
+}
+
+// Test that two obvious communities are found
+void testTwoCliques() {
+    std::cout << "Testing label propagation on two cliques..." << std::endl;
+    auto g = createTwoCliqueGraph();
+
+    LabelPropagationDetection<int> lpa;
+    std::vector<Community<int>> communities = lpa.detectCommunitiesFromGraph(g);
+
+    assert(communities.size() == 2);
+    for (const auto& community : communities) {
+        assert(community.size() == 5);
+        assert(community.containsNode(1) == community.containsNode(5));
+        assert(community.containsNode(6) == community.containsNode(10));
+    }
+    assert(lpa.getLastIterationCount() >= 1);
+
+    std::cout << "Two cliques test passed!" << std::endl;
+}
+
+// Test that the multi-threaded run reproduces the sequential run exactly
+void testParallelMatchesSequential() {
+    std::cout << "Testing parallel label propagation against sequential..." << std::endl;
+    auto g = createPlantedGraph(7);
+
+    LabelPropagationDetection<int> sequential(1);
+    std::vector<Community<int>> expected = sequential.detectCommunitiesFromGraph(g);
+    double expectedModularity = g->calculateModularity(expected);
+    std::cout << "Sequential: " << expected.size() << " communities, modularity " << expectedModularity << std::endl;
+    assert(expectedModularity > 0.6);
+
+    for (unsigned threads : {2u, 3u, 8u}) {
+        LabelPropagationDetection<int> parallel(threads);
+        assert(parallel.getNumThreads() == threads);
+        std::vector<Community<int>> actual = parallel.detectCommunitiesFromGraph(g);
+        assert(actual.size() == expected.size());
+        for (size_t c = 0; c < actual.size(); c++) {
+            assert(actual[c] == expected[c]);
+        }
+        assert(parallel.getLastIterationCount() == sequential.getLastIterationCount());
+        assert(g->calculateModularity(actual) == expectedModularity);
+    }
+
+    // 0 threads means all hardware threads
+    LabelPropagationDetection<int> automatic(0);
+    assert(automatic.getNumThreads() >= 1);
+
+    std::cout << "Parallel label propagation test passed!" << std::endl;
+}
+
+// Test graphs without edges and the iteration limit
+void testDegenerateGraphs() {
+    std::cout << "Testing label propagation on degenerate graphs..." << std::endl;
+    LabelPropagationDetection<int> lpa(4);
+
+    auto empty = std::make_shared<Graph<int>>();
+    assert(lpa.detectCommunitiesFromGraph(empty).empty());
+
+    auto isolated = std::make_shared<Graph<int>>();
+    isolated->addVertex(1);
+    isolated->addVertex(2);
+    assert(lpa.detectCommunitiesFromGraph(isolated).size() == 2);
+
+    lpa.setMaxIterations(1);
+    lpa.detectCommunitiesFromGraph(createPlantedGraph(3));
+    assert(lpa.getLastIterationCount() == 1);
+    assert(lpa.getLastColorCount() >= 2);
+
+    std::cout << "Degenerate graphs test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LabelPropagation tests..." << std::endl;
+
+    testTwoCliques();
+    testParallelMatchesSequential();
+    testDegenerateGraphs();
+
+    std::cout << "All LabelPropagation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "../CLASSES/LfrGenerator/LfrGenerator.h"
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include "../CLASSES/CommunityComparison/CommunityComparison.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+
+// Time to generate LFR networks and build their Graph<int>, and how well
+// Louvain recovers the planted communities. Sizes can be overridden:
+//     lfr_generator_benchmark [numNodes] [averageDegree] [maxDegree] [mixing] [detectUpToNodes]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    LfrParameters params;
+    params.numNodes = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    params.averageDegree = argc > 2 ? std::stod(argv[2]) : 20;
+    params.maxDegree = argc > 3 ? std::stoul(argv[3]) : 100;
+    params.mixing = argc > 4 ? std::stod(argv[4]) : 0.3;
+    uint32_t detectUpToNodes = argc > 5 ? std::stoul(argv[5]) : 200000;
+    params.degreeExponent = 2;
+    params.communityExponent = 1;
+    params.minCommunity = 20;
+    params.maxCommunity = 1000;
+
+    std::cout << "LFR networks (tau1 2, tau2 1, communities 20 - 1000, average degree " << params.averageDegree
+              << ", max degree " << params.maxDegree << ", mu " << params.mixing << ")" << std::endl;
+    for (uint32_t numNodes = params.numNodes; numNodes >= 10000; numNodes /= 10) {
+        params.numNodes = numNodes;
+        auto start = Clock::now();
+        LfrGenerator<int> lfr(params);
+        double generateSeconds = secondsSince(start);
+
+        start = Clock::now();
+        auto graph = lfr.buildGraph();
+        double buildSeconds = secondsSince(start);
+
+        start = Clock::now();
+        auto truth = lfr.buildCommunities();
+        double communitySeconds = secondsSince(start);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  " << std::setw(9) << numNodes << " nodes " << std::setw(9) << lfr.getEdges().size() << " edges "
+                  << std::setw(6) << lfr.getCommunityCount() << " communities, measured mu "
+                  << std::setprecision(3) << lfr.measuredMixing() << std::setprecision(2)
+                  << "   generate " << std::setw(5) << generateSeconds << " s, Graph " << std::setw(5) << buildSeconds
+                  << " s, communities " << communitySeconds << " s";
+        if (numNodes <= detectUpToNodes) {
+            LouvainDetection<int> louvain;
+            auto detected = louvain.detectCommunitiesFromGraph(graph);
+            CommunityComparison<int> cc;
+            std::cout << ", Louvain NMI " << std::setprecision(3) << cc.calculateNMI(truth, detected);
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "../CLASSES/LfrGenerator/LfrGenerator.h"
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include "../CLASSES/CommunityComparison/CommunityComparison.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <set>
+
+LfrParameters smallParameters() {
+    LfrParameters params;
+    params.numNodes = 5000;
+    params.averageDegree = 15;
+    params.maxDegree = 50;
+    params.degreeExponent = 2;
+    params.communityExponent = 1;
+    params.mixing = 0.2;
+    params.minCommunity = 20;
+    params.maxCommunity = 100;
+    params.seed = 7;
+    return params;
+}
+
+// Test the degree, community size and mixing targets
+void testNetworkShape() {
+    std::cout << "Testing LFR network shape..." << std::endl;
+
+    LfrParameters params = smallParameters();
+    LfrGenerator<int> lfr(params);
+    auto graph = lfr.buildGraph();
+
+    assert(graph->getVertexCount() == params.numNodes);
+    assert(graph->getEdgeCount() == lfr.getEdges().size());
+    double averageDegree = 2.0 * graph->getEdgeCount() / params.numNodes;
+    assert(std::abs(averageDegree - params.averageDegree) < 0.05 * params.averageDegree);
+    for (int v : graph->getVertices()) {
+        assert(graph->getDegree(v) <= static_cast<int>(params.maxDegree));
+        assert(!graph->hasEdge(v, v));
+    }
+    assert(std::abs(lfr.measuredMixing() - params.mixing) < 0.02);
+
+    // Every node in exactly one community of the requested size range
+    auto communities = lfr.buildCommunities();
+    assert(communities.size() == lfr.getCommunityCount());
+    size_t covered = 0;
+    for (const auto& community : communities) {
+        assert(community.size() >= params.minCommunity && community.size() <= params.maxCommunity);
+        covered += community.size();
+    }
+    assert(covered == params.numNodes);
+    for (uint32_t v = 0; v < params.numNodes; v++) {
+        assert(communities[lfr.getMembership()[v]].containsNode(static_cast<int>(v)));
+    }
+
+    // Mixing counted from the graph matches the generator's count
+    size_t external = 0;
+    for (const auto& [a, b] : lfr.getEdges()) {
+        external += lfr.getMembership()[a] != lfr.getMembership()[b];
+    }
+    assert(std::abs(static_cast<double>(external) / lfr.getEdges().size() - lfr.measuredMixing()) < 1e-12);
+
+    std::cout << "LFR network shape test passed!" << std::endl;
+}
+
+// Test that a seed always gives the same network
+void testReproducible() {
+    std::cout << "Testing LFR reproducibility..." << std::endl;
+
+    LfrParameters params = smallParameters();
+    LfrGenerator<int> first(params);
+    LfrGenerator<int> second(params);
+    assert(first.getEdges() == second.getEdges());
+    assert(first.getMembership() == second.getMembership());
+
+    params.seed = 8;
+    LfrGenerator<int> other(params);
+    assert(first.getEdges() != other.getEdges());
+
+    // String vertices are the decimal ids of the same network
+    params.seed = 7;
+    LfrGenerator<std::string> named(params);
+    auto graph = named.buildGraph();
+    const auto& [a, b] = first.getEdges().front();
+    assert(graph->hasEdge(std::to_string(a), std::to_string(b)));
+    assert(named.buildCommunities()[first.getMembership()[a]].containsNode(std::to_string(a)));
+
+    std::cout << "LFR reproducibility test passed!" << std::endl;
+}
+
+// Test that low mixing yields communities Louvain can recover
+void testDetectable() {
+    std::cout << "Testing LFR community recovery..." << std::endl;
+
+    LfrParameters params = smallParameters();
+    params.mixing = 0.1;
+    LfrGenerator<int> lfr(params);
+    LouvainDetection<int> louvain;
+    auto detected = louvain.detectCommunitiesFromGraph(lfr.buildGraph());
+    CommunityComparison<int> cc;
+    assert(cc.calculateNMI(lfr.buildCommunities(), detected) > 0.9);
+
+    // Mixing of 0.9 leaves almost no structure
+    params.mixing = 0.9;
+    LfrGenerator<int> mixed(params);
+    assert(std::abs(mixed.measuredMixing() - 0.9) < 0.02);
+
+    std::cout << "LFR community recovery test passed!" << std::endl;
+}
+
+// Test parameter validation
+void testInvalidParameters() {
+    std::cout << "Testing LFR parameter validation..." << std::endl;
+
+    auto throwsInvalid = [](LfrParameters params) {
+        try {
+            LfrGenerator<int> lfr(params);
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    LfrParameters params = smallParameters();
+    params.mixing = 1.5;
+    assert(throwsInvalid(params));
+    params = smallParameters();
+    params.averageDegree = 60;  // above the maximum degree
+    assert(throwsInvalid(params));
+    params = smallParameters();
+    params.minCommunity = 200;
+    assert(throwsInvalid(params));
+    params = smallParameters();
+    params.maxDegree = params.numNodes;
+    assert(throwsInvalid(params));
+
+    std::cout << "LFR parameter validation test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LfrGenerator tests..." << std::endl;
+
+    testNetworkShape();
+    testReproducible();
+    testDetectable();
+    testInvalidParameters();
+
+    std::cout << "All LfrGenerator tests passed!" << std::endl;
+    return 0;
+}
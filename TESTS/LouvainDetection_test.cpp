@@ -0,0 +1,170 @@
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+// Helper function to check if two doubles are approximately equal
+bool approxEqual(double a, double b, double epsilon = 1e-9) {
+    return std::abs(a - b) < epsilon;
+}
+
+// Two 4-cliques joined by a single weak edge
+std::shared_ptr<Graph<int>> createTwoCliqueGraph() {
+    auto g = std::make_shared<Graph<int>>();
+    for (int i = 1; i <= 4; i++) {
+        for (int j = i + 1; j <= 4; j++) {
+            g->addEdge(i, j, 1.0);
+            g->addEdge(i + 4, j + 4, 1.0);
+        }
+    }
+    g->addEdge(4, 5, 0.5);
+    return g;
+}
+
+// Zachary's karate club (78 edges)
+std::shared_ptr<Graph<int>> createKarateClubGraph() {
+    const int edges[][2] = {
+        {1, 2}, {1, 3}, {1, 4}, {1, 5}, {1, 6}, {1, 7}, {1, 8}, {1, 9}, {1, 11}, {1, 12},
+        {1, 13}, {1, 14}, {1, 18}, {1, 20}, {1, 22}, {1, 32}, {2, 3}, {2, 4}, {2, 8}, {2, 14},
+        {2, 18}, {2, 20}, {2, 22}, {2, 31}, {3, 4}, {3, 8}, {3, 9}, {3, 10}, {3, 14}, {3, 28},
+        {3, 29}, {3, 33}, {4, 8}, {4, 13}, {4, 14}, {5, 7}, {5, 11}, {6, 7}, {6, 11}, {6, 17},
+        {7, 17}, {9, 31}, {9, 33}, {9, 34}, {10, 34}, {14, 34}, {15, 33}, {15, 34}, {16, 33}, {16, 34},
+        {19, 33}, {19, 34}, {20, 34}, {21, 33}, {21, 34}, {23, 33}, {23, 34}, {24, 26}, {24, 28}, {24, 30},
+        {24, 33}, {24, 34}, {25, 26}, {25, 28}, {25, 32}, {26, 32}, {27, 30}, {27, 34}, {28, 34}, {29, 32},
+        {29, 34}, {30, 33}, {30, 34}, {31, 33}, {31, 34}, {32, 33}, {32, 34}, {33, 34}
+    };
+    auto g = std::make_shared<Graph<int>>();
+    for (const auto& edge : edges) {
+        g->addEdge(edge[0], edge[1], 1.0);
+    }
+    return g;
+}
+
+// Test that two obvious communities are found
+void testTwoCliques() {
+    std::cout << "Testing Louvain on two cliques..." << std::endl;
+    auto g = createTwoCliqueGraph();
+
+    LouvainDetection<int> louvain;
+    std::vector<Community<int>> communities = louvain.detectCommunitiesFromGraph(g);
+
+    assert(communities.size() == 2);
+    assert(communities[0].size() == 4);
+    assert(communities[0].containsNode(1) && communities[0].containsNode(4));
+    assert(communities[1].containsNode(5) && communities[1].containsNode(8));
+
+    // The tracked modularity matches a from-scratch computation
+    assert(approxEqual(louvain.getLastModularity(), g->calculateModularity(communities)));
+
+    std::cout << "Two cliques test passed!" << std::endl;
+}
+
+// Test on the karate club, whose best known modularity is about 0.4198
+void testKarateClub() {
+    std::cout << "Testing Louvain on Zachary's karate club..." << std::endl;
+    auto g = createKarateClubGraph();
+    assert(g->getEdgeCount() == 78);
+
+    LouvainDetection<int> louvain(g);
+    std::vector<Community<int>> communities = louvain.detectCommunitiesFromGraph(g);
+
+    size_t totalNodes = 0;
+    for (const auto& community : communities) {
+        totalNodes += community.size();
+    }
+    assert(totalNodes == 34);
+
+    double modularity = g->calculateModularity(communities);
+    std::cout << "Karate club: " << communities.size() << " communities, modularity " << modularity << std::endl;
+    assert(modularity > 0.40 && modularity < 0.42);
+    assert(approxEqual(louvain.getLastModularity(), modularity));
+    assert(louvain.getLastLevelCount() >= 1);
+
+    // Shuffled visit orders still give a good partition
+    louvain.setSeed(12345);
+    double shuffledModularity = g->calculateModularity(louvain.detectCommunitiesFromGraph(g));
+    assert(shuffledModularity > 0.38);
+
+    std::cout << "Karate club test passed!" << std::endl;
+}
+
+// Test graphs without edges and isolated vertices
+void testDegenerateGraphs() {
+    std::cout << "Testing Louvain on degenerate graphs..." << std::endl;
+    LouvainDetection<int> louvain;
+
+    auto empty = std::make_shared<Graph<int>>();
+    assert(louvain.detectCommunitiesFromGraph(empty).empty());
+
+    auto isolated = createTwoCliqueGraph();
+    isolated->addVertex(42);
+    std::vector<Community<int>> communities = louvain.detectCommunitiesFromGraph(isolated);
+    assert(communities.size() == 3);
+
+    bool foundSingleton = false;
+    for (const auto& community : communities) {
+        if (community.containsNode(42)) {
+            foundSingleton = community.size() == 1;
+        }
+    }
+    assert(foundSingleton);
+
+    // Only one aggregation level allowed
+    louvain.setMaxLevels(1);
+    louvain.detectCommunitiesFromGraph(createKarateClubGraph());
+    assert(louvain.getLastLevelCount() == 1);
+
+    std::cout << "Degenerate graphs test passed!" << std::endl;
+}
+
+// Test file based detection and batch processing
+void testBatchProcess() {
+    std::cout << "Testing Louvain batch processing..." << std::endl;
+    createTwoCliqueGraph()->saveToFile("louvain_input_1.txt");
+    createKarateClubGraph()->saveToFile("louvain_input_2.txt");
+
+    LouvainDetection<int> louvain;
+    louvain.batchProcess({"louvain_input_1.txt", "louvain_input_2.txt"},
+                         {"louvain_output_1.txt", "louvain_output_2.txt"});
+
+    // Every vertex is written exactly once as "node community"
+    std::ifstream output("louvain_output_1.txt");
+    int node, community, lines = 0;
+    std::set<int> seenCommunities;
+    while (output >> node >> community) {
+        seenCommunities.insert(community);
+        lines++;
+    }
+    assert(lines == 8);
+    assert(seenCommunities.size() == 2);
+
+    bool threw = false;
+    try {
+        louvain.batchProcess({"louvain_input_1.txt"}, {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    for (const char* file : {"louvain_input_1.txt", "louvain_input_2.txt", "louvain_output_1.txt", "louvain_output_2.txt"}) {
+        std::remove(file);
+    }
+
+    std::cout << "Batch processing test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LouvainDetection tests..." << std::endl;
+
+    testTwoCliques();
+    testKarateClub();
+    testDegenerateGraphs();
+    testBatchProcess();
+
+    std::cout << "All LouvainDetection tests passed!" << std::endl;
+    return 0;
+}
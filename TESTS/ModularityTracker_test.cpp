@@ -0,0 +1,160 @@
+#include "../CLASSES/ModularityTracker/ModularityTracker.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+// Helper function to check if two doubles are approximately equal
+bool approxEqual(double a, double b, double epsilon = 1e-9) {
+    return std::abs(a - b) < epsilon;
+}
+
+// Two weighted triangles joined by one edge, plus a self-loop
+std::shared_ptr<Graph<int>> createTestGraph() {
+    auto g = std::make_shared<Graph<int>>();
+    g->addEdge(1, 2, 1.0);
+    g->addEdge(2, 3, 2.0);
+    g->addEdge(1, 3, 1.5);
+    g->addEdge(4, 5, 1.0);
+    g->addEdge(5, 6, 1.0);
+    g->addEdge(4, 6, 2.5);
+    g->addEdge(3, 4, 0.5);
+    g->addEdge(6, 6, 1.0);
+    return g;
+}
+
+std::vector<Community<int>> makeCommunities(const std::vector<std::vector<int>>& groups) {
+    std::vector<Community<int>> communities(groups.size());
+    for (size_t c = 0; c < groups.size(); c++) {
+        for (int node : groups[c]) {
+            communities[c].addNode(node);
+        }
+    }
+    return communities;
+}
+
+// Test that the tracked score matches calculateModularity
+void testInitialModularity() {
+    std::cout << "Testing initial tracked modularity..." << std::endl;
+    auto g = createTestGraph();
+
+    std::vector<Community<int>> communities = makeCommunities({{1, 2, 3}, {4, 5, 6}});
+    ModularityTracker<int> tracker(g, communities);
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(communities)));
+    assert(tracker.getCommunityCount() == 2);
+    assert(tracker.getCommunity(5) == 1);
+    assert(approxEqual(tracker.getInternalWeight(0), 4.5));
+    assert(approxEqual(tracker.getTotalDegree(0), g->getWeightedDegree(1) + g->getWeightedDegree(2) + g->getWeightedDegree(3)));
+
+    // Partial partition given as labels: node 6 belongs to no community
+    std::unordered_map<int, int> labels = {{1, 0}, {2, 0}, {3, 1}, {4, 1}, {5, 1}, {6, -1}};
+    ModularityTracker<int> partial(g, labels);
+    assert(approxEqual(partial.getModularity(), g->calculateModularity(labels)));
+    assert(partial.getCommunity(6) == -1);
+
+    // Overlapping communities are rejected
+    bool threw = false;
+    try {
+        ModularityTracker<int> overlapping(g, makeCommunities({{1, 2, 3}, {3, 4}}));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Initial modularity test passed!" << std::endl;
+}
+
+// Test deltaMove and applyMove against recomputation from scratch
+void testMoves() {
+    std::cout << "Testing node moves..." << std::endl;
+    auto g = createTestGraph();
+    ModularityTracker<int> tracker(g, makeCommunities({{1, 2, 3}, {4, 5, 6}}));
+
+    // A what-if query does not change the partition
+    double before = tracker.getModularity();
+    double delta = tracker.deltaMove(3, 1);
+    assert(tracker.getCommunity(3) == 0);
+    assert(tracker.getModularity() == before);
+    assert(delta < 0);
+
+    // Moving node 3 and moving it back
+    assert(approxEqual(tracker.applyMove(3, 1), delta));
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(tracker.getLabels())));
+    assert(tracker.getCommunitySize(1) == 4);
+    tracker.applyMove(3, 0);
+    assert(approxEqual(tracker.getModularity(), before));
+
+    // Self-loops stay out of L_c when the looped node moves
+    tracker.applyMove(6, 0);
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(tracker.getLabels())));
+
+    // A new label opens a new community, -1 leaves every community
+    tracker.applyMove(5, 2);
+    assert(tracker.getCommunityCount() == 3);
+    tracker.applyMove(1, -1);
+    assert(tracker.getCommunity(1) == -1);
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(tracker.getLabels())));
+    assert(tracker.deltaMove(1, -1) == 0.0);
+
+    std::vector<Community<int>> communities = tracker.getCommunities();
+    assert(communities.size() == 3);
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(communities)));
+
+    std::cout << "Node moves test passed!" << std::endl;
+}
+
+// Test a long random sequence of moves on a random graph
+void testRandomMoves() {
+    std::cout << "Testing random node moves..." << std::endl;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> anyVertex(0, 199);
+    std::uniform_int_distribution<int> anyCommunity(-1, 9);
+    std::uniform_real_distribution<double> anyWeight(0.5, 3.0);
+
+    auto g = std::make_shared<Graph<int>>();
+    for (int v = 0; v < 200; v++) {
+        g->addVertex(v);
+    }
+    for (int e = 0; e < 1000; e++) {
+        int u = anyVertex(rng), v = anyVertex(rng);
+        if (!g->hasEdge(u, v)) {
+            g->addEdge(u, v, anyWeight(rng));
+        }
+    }
+
+    std::unordered_map<int, int> labels;
+    for (int v = 0; v < 200; v++) {
+        labels[v] = v % 10;
+    }
+    ModularityTracker<int> tracker(g, labels);
+
+    for (int step = 0; step < 2000; step++) {
+        int node = anyVertex(rng);
+        int target = anyCommunity(rng);
+        double predicted = tracker.deltaMove(node, target);
+        double before = tracker.getModularity();
+        assert(tracker.applyMove(node, target) == predicted);
+        assert(approxEqual(tracker.getModularity() - before, predicted));
+    }
+    assert(approxEqual(tracker.getModularity(), g->calculateModularity(tracker.getLabels())));
+
+    double tracked = tracker.getModularity();
+    tracker.recompute();
+    assert(approxEqual(tracker.getModularity(), tracked));
+
+    std::cout << "Random node moves test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running ModularityTracker tests..." << std::endl;
+
+    testInitialModularity();
+    testMoves();
+    testRandomMoves();
+
+    std::cout << "All ModularityTracker tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "../CLASSES/NetworkGenerator/NetworkGenerator.h"
+#include "../CLASSES/LfrGenerator/LfrGenerator.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+
+// Time to generate WRG / BWRN networks from the block structure of an LFR
+// network, and to build their Graph<int>. Sizes can be overridden:
+//     network_generator_benchmark [numNodes] [averageDegree] [maxThreads]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    LfrParameters params;
+    params.numNodes = argc > 1 ? std::stoul(argv[1]) : 200000;
+    params.averageDegree = argc > 2 ? std::stod(argv[2]) : 20;
+    unsigned maxThreads = argc > 3 ? std::stoul(argv[3]) : std::max(4u, std::thread::hardware_concurrency());
+    params.maxDegree = 100;
+    params.mixing = 0.3;
+    params.minCommunity = 20;
+    params.maxCommunity = 1000;
+
+    // Observed network: LFR edges with weights 1 to 5
+    LfrGenerator<int> lfr(params);
+    std::map<int, std::vector<std::pair<int, int>>> nodeEdges;
+    for (const auto& [a, b] : lfr.getEdges()) {
+        int weight = 1 + static_cast<int>((a * 31u + b) % 5);
+        nodeEdges[a].push_back({static_cast<int>(b), weight});
+        nodeEdges[b].push_back({static_cast<int>(a), weight});
+    }
+    auto groups = lfr.buildCommunities();
+    std::cout << "Observed network: " << params.numNodes << " nodes, " << lfr.getEdges().size() << " edges, "
+              << groups.size() << " groups" << std::endl;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        NetworkGenerator<int> generator(threads, 42);
+        auto start = Clock::now();
+        auto wrg = generator.WRG(nodeEdges, groups);
+        double wrgSeconds = secondsSince(start);
+
+        start = Clock::now();
+        auto bwrn = generator.BWRN(nodeEdges, groups, 0.5);
+        double bwrnSeconds = secondsSince(start);
+
+        start = Clock::now();
+        auto graph = generator.generateGraph(wrg);
+        double graphSeconds = secondsSince(start);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  threads " << std::setw(2) << threads
+                  << ": WRG " << wrgSeconds << " s (" << wrg.size() << " edges), BWRN q=0.5 " << bwrnSeconds
+                  << " s (" << bwrn.size() << " edges), generateGraph " << graphSeconds << " s" << std::endl;
+    }
+    return 0;
+}
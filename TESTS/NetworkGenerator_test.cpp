@@ -0,0 +1,230 @@
+#include "../CLASSES/NetworkGenerator/NetworkGenerator.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/Community/Community.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <cstdio>
+#include <set>
+
+// Observed network: two groups of 40 nodes, dense heavy edges inside the
+// groups and a few light ones between them
+struct ObservedNetwork {
+    std::map<int, std::vector<std::pair<int, int>>> nodeEdges;
+    std::vector<Community<int>> groups;
+    double inside = 0;   // total weight inside the groups
+    double between = 0;  // total weight between the groups
+};
+
+ObservedNetwork createObservedNetwork() {
+    ObservedNetwork observed;
+    observed.groups.resize(2);
+    for (int v = 0; v < 80; v++) {
+        observed.groups[v / 40].addNode(v);
+    }
+    auto connect = [&](int a, int b, int weight) {
+        observed.nodeEdges[a].push_back({b, weight});
+        observed.nodeEdges[b].push_back({a, weight});
+        (a / 40 == b / 40 ? observed.inside : observed.between) += weight;
+    };
+    for (int a = 0; a < 80; a++) {
+        for (int b = a + 1; b < 80; b++) {
+            if (a / 40 == b / 40 && (a + b) % 3 == 0) connect(a, b, 1 + (a * b) % 4);
+            if (a / 40 != b / 40 && (a * b) % 17 == 0) connect(a, b, 1);
+        }
+    }
+    return observed;
+}
+
+// Total generated weight inside and between the two groups
+std::pair<double, double> blockWeights(const std::vector<NetworkGenerator<int>::WeightedEdge>& edges) {
+    double inside = 0, between = 0;
+    for (const auto& [a, b, weight] : edges) {
+        (a / 40 == b / 40 ? inside : between) += weight;
+    }
+    return {inside, between};
+}
+
+// Test that generated networks keep the block weights on average
+void testBlockWeights() {
+    std::cout << "Testing generated block weights..." << std::endl;
+
+    ObservedNetwork observed = createObservedNetwork();
+    NetworkGenerator<int> generator(1, 5);
+    const int networks = 300;
+    for (int model = 0; model < 3; model++) {
+        double inside = 0, between = 0;
+        for (int i = 0; i < networks; i++) {
+            auto edges = model == 0 ? generator.WRG(observed.nodeEdges, observed.groups)
+                                    : generator.BWRN(observed.nodeEdges, observed.groups, model == 1 ? 0.3 : 0.9);
+            auto weights = blockWeights(edges);
+            inside += weights.first / networks;
+            between += weights.second / networks;
+
+            std::set<std::pair<int, int>> seen;
+            for (const auto& [a, b, weight] : edges) {
+                assert(a != b && weight >= 1);
+                assert(seen.insert({std::min(a, b), std::max(a, b)}).second);
+            }
+        }
+        assert(std::abs(inside - observed.inside) < 0.03 * observed.inside);
+        assert(std::abs(between - observed.between) < 0.1 * observed.between);
+    }
+
+    // A small success probability spreads the same weight over fewer edges
+    size_t bursty = 0, smooth = 0;
+    for (int i = 0; i < 50; i++) {
+        bursty += generator.BWRN(observed.nodeEdges, observed.groups, 0.05).size();
+        smooth += generator.BWRN(observed.nodeEdges, observed.groups, 0.95).size();
+    }
+    assert(bursty < smooth);
+
+    bool threw = false;
+    try {
+        generator.BWRN(observed.nodeEdges, observed.groups, 1.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "Generated block weights test passed!" << std::endl;
+}
+
+// Test that the seed, not the thread count, decides the network
+void testReproducible() {
+    std::cout << "Testing reproducible parallel generation..." << std::endl;
+
+    // Heavy enough for several chunks per block
+    std::map<int, std::vector<std::pair<int, int>>> nodeEdges;
+    std::vector<Community<int>> groups(3);
+    for (int v = 0; v < 3000; v++) {
+        groups[v % 3].addNode(v);
+        int u = (v * 7919 + 13) % 3000;
+        if (u != v) {
+            nodeEdges[v].push_back({u, 100});
+            nodeEdges[u].push_back({v, 100});
+        }
+    }
+
+    NetworkGenerator<int> sequential(1, 99);
+    NetworkGenerator<int> parallel(4, 99);
+    auto first = sequential.WRG(nodeEdges, groups);
+    assert(first == parallel.WRG(nodeEdges, groups));
+    assert(sequential.BWRN(nodeEdges, groups, 0.5) == parallel.BWRN(nodeEdges, groups, 0.5));
+
+    // Every call gives a new network; setSeed starts the sequence again
+    assert(sequential.WRG(nodeEdges, groups) != first);
+    sequential.setSeed(99);
+    assert(sequential.WRG(nodeEdges, groups) == first);
+
+    std::cout << "Reproducible parallel generation test passed!" << std::endl;
+}
+
+// Test building graphs and relabeling nodes
+void testGraphAndRandomIds() {
+    std::cout << "Testing generateGraph and randomizeNodeIds..." << std::endl;
+
+    std::map<std::string, std::vector<std::pair<std::string, int>>> nodeEdges;
+    std::vector<Community<std::string>> groups(2);
+    for (int v = 0; v < 30; v++) {
+        groups[v % 2].addNode("n" + std::to_string(v));
+        for (int u = 0; u < v; u++) {
+            if ((u + v) % 4 == 0) {
+                nodeEdges["n" + std::to_string(v)].push_back({"n" + std::to_string(u), 3});
+                nodeEdges["n" + std::to_string(u)].push_back({"n" + std::to_string(v), 3});
+            }
+        }
+    }
+    NetworkGenerator<std::string> generator(2, 1);
+    auto edges = generator.BWRN(nodeEdges, groups, 0.5);
+    auto graph = generator.generateGraph(edges);
+    assert(graph->getEdgeCount() == edges.size());
+    double total = 0;
+    for (const auto& [a, b, weight] : edges) {
+        assert(graph->getEdgeWeight(a, b) == weight);
+        total += weight;
+    }
+    assert(graph->getTotalWeight() == total);
+
+    std::ofstream ids("network_generator_ids.txt");
+    for (int id = 100; id < 140; id++) {
+        ids << "id" << id << (id % 10 == 9 ? "\n" : " ");
+    }
+    ids.close();
+    auto randomized = generator.randomizeNodeIds(edges, "network_generator_ids.txt", 40);
+    assert(randomized.size() == edges.size());
+
+    // Relabeling is one-to-one, so the degree sequence is unchanged
+    std::map<std::string, int> degreeBefore, degreeAfter;
+    std::map<std::string, std::string> renamed;
+    for (size_t i = 0; i < edges.size(); i++) {
+        const auto& [a, b, weight] = edges[i];
+        for (auto [node, id] : {std::make_pair(a, randomized[i].first), std::make_pair(b, randomized[i].second)}) {
+            assert(id.rfind("id", 0) == 0);
+            auto known = renamed.emplace(node, id);
+            assert(known.first->second == id);
+            degreeBefore[node]++;
+            degreeAfter[id]++;
+        }
+    }
+    std::set<std::string> distinctIds;
+    for (const auto& [node, id] : renamed) distinctIds.insert(id);
+    assert(distinctIds.size() == renamed.size());
+    for (const auto& [node, id] : renamed) assert(degreeBefore[node] == degreeAfter[id]);
+
+    bool threw = false;
+    try {
+        generator.randomizeNodeIds(edges, "network_generator_ids.txt", 41);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::remove("network_generator_ids.txt");
+
+    std::cout << "generateGraph and randomizeNodeIds test passed!" << std::endl;
+}
+
+// Test blocks whose edge probability is far below one per chunk of 2^64 pairs
+void testNearEmptyBlock() {
+    std::cout << "Testing a near-empty block..." << std::endl;
+
+    // One light edge between two groups of 40; with q = 1e-15 the chance
+    // of an edge per pair between the groups is about 2e-17
+    std::map<int, std::vector<std::pair<int, int>>> nodeEdges;
+    std::vector<Community<int>> groups(2);
+    for (int v = 0; v < 80; v++) {
+        groups[v / 40].addNode(v);
+    }
+    for (int v = 0; v < 39; v++) {
+        nodeEdges[v].push_back({v + 1, 2});
+        nodeEdges[v + 1].push_back({v, 2});
+    }
+    nodeEdges[0].push_back({40, 1});
+    nodeEdges[40].push_back({0, 1});
+
+    NetworkGenerator<int> sequential(1, 3);
+    NetworkGenerator<int> parallel(4, 3);
+    for (int i = 0; i < 20; i++) {
+        auto edges = sequential.BWRN(nodeEdges, groups, 1e-15);
+        assert(edges == parallel.BWRN(nodeEdges, groups, 1e-15));
+        for (const auto& [a, b, weight] : edges) {
+            assert(a != b && a / 40 == b / 40 && weight >= 1);
+        }
+    }
+
+    std::cout << "Near-empty block test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running NetworkGenerator tests..." << std::endl;
+
+    testBlockWeights();
+    testReproducible();
+    testGraphAndRandomIds();
+    testNearEmptyBlock();
+
+    std::cout << "All NetworkGenerator tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "../CLASSES/VertexDictionary/VertexDictionary.h"
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>        // For fork
+#include <sys/wait.h>      // For waitpid
+#include <sys/resource.h>  // For getrusage
+
+// Loading and clustering a graph with string vertex ids, as Graph<string>
+// and through a VertexDictionary as Graph<uint32_t>. Every run is forked so
+// its peak RSS is measured on its own.
+//     vertex_dictionary_benchmark [numVertices] [numEdges]
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+long peakRssKilobytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+template <typename Task>
+void measureInChild(const std::string& name, Task task) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        long baseline = peakRssKilobytes();
+        auto start = Clock::now();
+        size_t count = task();
+        double seconds = secondsSince(start);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  " << std::left << std::setw(34) << name << std::right
+                  << std::setw(7) << seconds << " s   peak RSS " << std::setw(7)
+                  << (peakRssKilobytes() - baseline) / 1024.0 << " MB above baseline   (" << count << ")" << std::endl;
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+// Random graph in the Graph2 text format with names too long for the
+// small string buffer, like user handles or URLs
+void writeStringGraph(const std::string& filename, size_t numVertices, size_t numEdges) {
+    std::mt19937_64 rng(42);
+    std::vector<std::string> names(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) {
+        names[v] = "user_" + std::to_string(rng() % 1000000000000ULL) + "_" + std::to_string(v);
+    }
+    std::uniform_int_distribution<size_t> pickVertex(0, numVertices - 1);
+    std::unordered_set<std::pair<size_t, size_t>, PairHash<size_t>> seen;
+    seen.reserve(numEdges);
+
+    std::ofstream file(filename);
+    file << numVertices << "\n";
+    for (const auto& name : names) {
+        file << name << " ";
+    }
+    file << "\n" << numEdges << "\n";
+    while (seen.size() < numEdges) {
+        size_t from = pickVertex(rng);
+        size_t to = pickVertex(rng);
+        if (from == to || !seen.insert(std::minmax(from, to)).second) {
+            continue;
+        }
+        file << names[from] << " " << names[to] << " " << 1 + rng() % 5 << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t numVertices = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t numEdges = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    const std::string filename = "vertex_dictionary_benchmark_graph.txt";
+    const std::string output = "vertex_dictionary_benchmark_communities.txt";
+    writeStringGraph(filename, numVertices, numEdges);
+    std::cout << "String vertex ids (" << numVertices << " vertices, " << numEdges << " edges)" << std::endl;
+
+    measureInChild("Graph<string>::loadBulk", [&] {
+        return Graph<std::string>::loadBulk(filename).getEdgeCount();
+    });
+    measureInChild("VertexDictionary::loadGraph", [&] {
+        VertexDictionary<std::string> dictionary;
+        return dictionary.loadGraph(filename).getEdgeCount();
+    });
+    measureInChild("load + Louvain + write, string", [&] {
+        auto graph = std::make_shared<Graph<std::string>>(Graph<std::string>::loadBulk(filename));
+        LouvainDetection<std::string> louvain;
+        auto communities = louvain.detectCommunitiesFromGraph(graph);
+        louvain.writeCommunities(communities, output);
+        return communities.size();
+    });
+    measureInChild("load + Louvain + write, interned", [&] {
+        VertexDictionary<std::string> dictionary;
+        auto graph = std::make_shared<Graph<uint32_t>>(dictionary.loadGraph(filename));
+        LouvainDetection<uint32_t> louvain;
+        auto communities = louvain.detectCommunitiesFromGraph(graph);
+        dictionary.writeCommunities(communities, output);
+        return communities.size();
+    });
+
+    std::remove(filename.c_str());
+    std::remove(output.c_str());
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "../CLASSES/VertexDictionary/VertexDictionary.h"
+#include "../CLASSES/Graph2/Graph2.h"
+#include "../CLASSES/CommunityComparison/CommunityComparison.h"
+#include "../CLASSES/LouvainDetection/LouvainDetection.h"
+#include <iostream>
+#include <string>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <cstdio>
+
+// String-keyed graph: two cliques of five joined by one light edge
+void writeStringGraph(const std::string& filename) {
+    std::vector<std::string> names = {"alice", "bob", "carol", "dave", "erin",
+                                      "frank", "grace", "heidi", "ivan", "judy"};
+    std::ofstream file(filename);
+    file << names.size() << "\n";
+    for (const auto& name : names) file << name << " ";
+    file << "\n" << 21 << "\n";
+    for (int clique = 0; clique < 2; clique++) {
+        for (int a = 0; a < 5; a++) {
+            for (int b = a + 1; b < 5; b++) {
+                file << names[5 * clique + a] << " " << names[5 * clique + b] << " " << 2.0 << "\n";
+            }
+        }
+    }
+    file << "erin frank 0.5\n";
+}
+
+// Test interning, lookups and copies
+void testInterning() {
+    std::cout << "Testing vertex interning..." << std::endl;
+
+    VertexDictionary<std::string> dictionary;
+    assert(dictionary.intern("x") == 0);
+    assert(dictionary.intern("y") == 1);
+    assert(dictionary.intern("x") == 0);
+    assert(dictionary.size() == 2);
+    assert(dictionary.find("y") == 1 && dictionary.find("z") == VertexDictionary<std::string>::NOT_FOUND);
+    assert(dictionary.vertex(1) == "y");
+
+    // Copies own their names; the original can keep growing
+    VertexDictionary<std::string> copy = dictionary;
+    for (int i = 0; i < 1000; i++) {
+        dictionary.intern("v" + std::to_string(i));
+    }
+    assert(copy.size() == 2 && copy.find("x") == 0 && !copy.contains("v5"));
+    assert(dictionary.find("v999") == 1001 && dictionary.vertex(2) == "v0");
+
+    bool threw = false;
+    try {
+        copy.vertex(2);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    VertexDictionary<int> numbers;
+    assert(numbers.intern(-7) == 0 && numbers.intern(40) == 1 && numbers.vertex(0) == -7);
+
+    std::cout << "Vertex interning test passed!" << std::endl;
+}
+
+// Test that the interned graph matches the string graph
+void testLoadGraph() {
+    std::cout << "Testing interned graph loading..." << std::endl;
+
+    writeStringGraph("vertex_dictionary_graph.txt");
+    Graph<std::string> named = Graph<std::string>::loadBulk("vertex_dictionary_graph.txt");
+    VertexDictionary<std::string> dictionary;
+    Graph<uint32_t> interned = dictionary.loadGraph("vertex_dictionary_graph.txt");
+
+    assert(interned.getVertexCount() == named.getVertexCount());
+    assert(interned.getEdgeCount() == named.getEdgeCount());
+    assert(interned.getTotalWeight() == named.getTotalWeight());
+    for (const auto& [edge, weight] : named.getEdgesWithWeight()) {
+        assert(interned.getEdgeWeight(dictionary.find(edge.first), dictionary.find(edge.second)) == weight);
+    }
+    for (const auto& vertex : named.getVertices()) {
+        assert(interned.getWeightedDegree(dictionary.find(vertex)) == named.getWeightedDegree(vertex));
+    }
+
+    // Detection runs on integers and is translated back on output
+    LouvainDetection<uint32_t> louvain;
+    auto communities = louvain.detectCommunitiesFromGraph(std::make_shared<Graph<uint32_t>>(interned));
+    auto decoded = dictionary.decode(communities);
+    assert(decoded.size() == 2);
+    for (const auto& community : decoded) {
+        assert(community.size() == 5);
+        assert(community.containsNode("alice") != community.containsNode("judy"));
+    }
+    assert(dictionary.encode(decoded) == communities);
+
+    // Errors match Graph<T>::loadBulk
+    std::ofstream("vertex_dictionary_bad.txt") << "2\na b\n1\na c 1.0\n";
+    bool threw = false;
+    try {
+        dictionary.loadGraph("vertex_dictionary_bad.txt");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    std::ofstream("vertex_dictionary_bad.txt") << "2\na a\n0\n";
+    threw = false;
+    try {
+        dictionary.loadGraph("vertex_dictionary_bad.txt");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::remove("vertex_dictionary_graph.txt");
+    std::remove("vertex_dictionary_bad.txt");
+    std::cout << "Interned graph loading test passed!" << std::endl;
+}
+
+// Test comparing interned community files
+void testCommunities() {
+    std::cout << "Testing interned communities..." << std::endl;
+
+    std::ofstream("vertex_dictionary_truth.txt") << "ann 0\nben 0\ncid 1\ndan 1\neve 2\nbad line\n";
+    std::ofstream("vertex_dictionary_found.txt") << "ann 5\nben 5\ncid 5\ndan 3\neve 3\n";
+
+    VertexDictionary<std::string> dictionary;
+    auto truth = dictionary.loadCommunities("vertex_dictionary_truth.txt");
+    auto found = dictionary.loadCommunities("vertex_dictionary_found.txt");
+    assert(dictionary.size() == 5 && !dictionary.contains("bad"));
+    assert(truth.size() == 3 && found.size() == 2);
+    assert(found[0].containsNode(dictionary.find("eve")));  // community 3 before 5
+
+    CommunityComparison<uint32_t> interned;
+    CommunityComparison<std::string> named;
+    double expected = named.calculateNMI(named.loadCommunities("vertex_dictionary_truth.txt"),
+                                         named.loadCommunities("vertex_dictionary_found.txt"));
+    assert(std::abs(interned.calculateNMI(truth, found) - expected) < 1e-12);
+
+    dictionary.writeCommunities(found, "vertex_dictionary_out.txt");
+    CommunityComparison<std::string> reader;
+    auto written = reader.loadCommunities("vertex_dictionary_out.txt");
+    assert(written == dictionary.decode(found));
+
+    std::remove("vertex_dictionary_truth.txt");
+    std::remove("vertex_dictionary_found.txt");
+    std::remove("vertex_dictionary_out.txt");
+    std::cout << "Interned communities test passed!" << std::endl;
+}
+
+int main() {
+    std::cout << "Running VertexDictionary tests..." << std::endl;
+
+    testInterning();
+    testLoadGraph();
+    testCommunities();
+
+    std::cout << "All VertexDictionary tests passed!" << std::endl;
+    return 0;
+}